@@ -0,0 +1,364 @@
+/**  \brief This main file runs the benchmark suite of the ABP simulator
+ *
+ * Microbenchmarks time the pieces a run is made of: the transitions
+ * of the sender, the receiver and the subnet called directly, the
+ * construction of message bags, the parsing of input files and the
+ * transformation of the log into its table. Macrobenchmarks run the
+ * headless top model for 10^3 packets and every power of ten up to
+ * the maximum given. Every benchmark uses fixed inputs and seeds so
+ * runs of different versions can be compared.
+ *
+ * The results, operations per second, are printed and written as
+ * JSON to track regressions between versions.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <cadmium/modeling/message_bag.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../lib/vendor/iestream.hpp"
+#include "../../include/data_structures/message.hpp"
+#include "../../include/atomics/sender_cadmium.hpp"
+#include "../../include/atomics/receiver_cadmium.hpp"
+#include "../../include/atomics/subnet_cadmium.hpp"
+#include "../../include/metrics/profiled.hpp"
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/top_model/abp_replications.hpp"
+#include "../../include/transform_output/transform_output.hpp"
+
+//define default output, input files and sizes of the benchmarks
+#define BENCH_JSON_FILE_PATH "bin/bench/bench_suite.json"
+#define BENCH_INPUT_FILE_PATH "bin/bench/bench_suite_input.txt"
+#define BENCH_LOG_FILE_PATH "data/top_model/abp_output.txt"
+#define BENCH_OPERATIONS 1000000
+#define BENCH_MAX_PACKETS 1000000
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Result of a benchmark
+ */
+struct bench_result {
+    string name;       /**< Name of the benchmark */
+    string unit;       /**< What an operation is */
+    uint64_t operations; /**< Operations done */
+    double seconds;    /**< Wall time taken */
+};
+
+/**
+ * Messages output by the microbenchmarks, kept so their
+ * output functions are not optimized away
+ */
+volatile uint64_t sink;
+
+/**
+ * Seconds elapsed since start
+ */
+double seconds_since(hclock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::duration<double,
+           std::ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Stream buffer dropping what is written to it, so writing
+ * is not measured with the transformation
+ */
+class null_streambuf : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override {
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        return n;
+    }
+};
+
+/**
+ * Sender sending packets that are all acknowledged: each packet is
+ * prepared, sent and acknowledged
+ * @param count number of transitions
+ */
+bench_result bench_sender(uint64_t count) {
+    Sender<TIME> sender;
+    typename make_message_bags<Sender<TIME>::input_ports>::type control;
+    get_messages<sender_defs::controlIn>(control).push_back(message_t(count));
+    sender.external_transition(TIME(), control);
+
+    uint64_t transitions = 0, messages = 0;
+    auto start = hclock::now();
+    while (transitions < count) {
+        sender.time_advance();
+        auto out = sender.output();
+        messages += get_messages<sender_defs::dataOut>(out).size();
+        sender.internal_transition();
+        transitions++;
+        if (!sender.state.sending && !sender.state.ack) {
+            typename make_message_bags<Sender<TIME>::input_ports>::type ack;
+            get_messages<sender_defs::ackIn>(ack).push_back(message_t(sender.state.packet_num,
+                                                                      sender.state.alt_bit));
+            sender.external_transition(TIME({0, 0, 1}), std::move(ack));
+            transitions++;
+        }
+    }
+    double seconds = seconds_since(start);
+    sink += messages;
+    return {"sender transitions", "transition", transitions, seconds};
+}
+
+/**
+ * Receiver acknowledging packets
+ * @param count number of transitions
+ */
+bench_result bench_receiver(uint64_t count) {
+    Receiver<TIME> receiver;
+    uint64_t transitions = 0, messages = 0;
+    auto start = hclock::now();
+    for (uint64_t i = 0; transitions < count; i++) {
+        typename make_message_bags<Receiver<TIME>::input_ports>::type in;
+        get_messages<receiver_defs::in>(in).push_back(message_t(i, i % 2));
+        receiver.external_transition(TIME({0, 0, 1}), std::move(in));
+        receiver.time_advance();
+        auto out = receiver.output();
+        messages += get_messages<receiver_defs::out>(out).size();
+        receiver.internal_transition();
+        transitions += 2;
+    }
+    double seconds = seconds_since(start);
+    sink += messages;
+    return {"receiver transitions", "transition", transitions, seconds};
+}
+
+/**
+ * Subnet passing or losing packets with its random draws
+ * @param count number of transitions
+ */
+bench_result bench_subnet(uint64_t count) {
+    Subnet<TIME> subnet;
+    uint64_t transitions = 0, messages = 0;
+    auto start = hclock::now();
+    for (uint64_t i = 0; transitions < count; i++) {
+        typename make_message_bags<Subnet<TIME>::input_ports>::type in;
+        get_messages<subnet_defs::in>(in).push_back(message_t(i, i % 2));
+        subnet.external_transition(TIME({0, 0, 1}), std::move(in));
+        subnet.time_advance();
+        auto out = subnet.output();
+        messages += get_messages<subnet_defs::out>(out).size();
+        subnet.internal_transition();
+        transitions += 2;
+    }
+    double seconds = seconds_since(start);
+    sink += messages;
+    return {"subnet transitions", "transition", transitions, seconds};
+}
+
+/**
+ * Builds the output bags of the sender, as its output function does
+ * @param count number of bags
+ */
+bench_result bench_message_bags(uint64_t count) {
+    uint64_t messages = 0;
+    auto start = hclock::now();
+    for (uint64_t i = 0; i < count; i++) {
+        typename make_message_bags<Sender<TIME>::output_ports>::type bags;
+        get_messages<sender_defs::dataOut>(bags).push_back(message_t(i, i % 2));
+        get_messages<sender_defs::packetSentOut>(bags).push_back(message_t(i));
+        messages += get_messages<sender_defs::dataOut>(bags).size();
+    }
+    double seconds = seconds_since(start);
+    sink += messages;
+    return {"message bags", "bag", count, seconds};
+}
+
+/**
+ * Parses an input file of generated lines
+ * @param count number of lines
+ */
+bench_result bench_parser(uint64_t count) {
+    FILE *file = fopen(BENCH_INPUT_FILE_PATH, "w");
+    for (uint64_t i = 0; i < count; i++) {
+        fprintf(file, "%02llu:%02llu:%02llu:%03llu %llu:%llu\n",
+                (unsigned long long)(i / 3600000), (unsigned long long)(i / 60000 % 60),
+                (unsigned long long)(i / 1000 % 60), (unsigned long long)(i % 1000),
+                (unsigned long long)(i % 1000), (unsigned long long)(i % 2));
+    }
+    fclose(file);
+
+    uint64_t lines = 0;
+    auto start = hclock::now();
+    Parser<TIME, message_t> parser(BENCH_INPUT_FILE_PATH);
+    std::pair<TIME, message_t> timed_input;
+    while (parser.next_timed_input(timed_input)) {
+        lines++;
+    }
+    double seconds = seconds_since(start);
+    remove(BENCH_INPUT_FILE_PATH);
+    return {"iestream parsing", "line", lines, seconds};
+}
+
+/**
+ * Transforms the lines of the simulator log into the table, the
+ * log being repeated to reach the number of lines
+ * @param count number of lines
+ */
+bench_result bench_transform(uint64_t count) {
+    vector<string> log;
+    ifstream file(BENCH_LOG_FILE_PATH);
+    string line;
+    while (getline(file, line)) {
+        log.push_back(line);
+    }
+    if (log.empty()) {
+        log.push_back("[sender_defs::packetSentOut: {1}, sender_defs::ackReceivedOut: {}, "
+                      "sender_defs::dataOut: {1:1}] generated by model sender1");
+    }
+
+    null_streambuf null;
+    ostream table(&null);
+    output_transformer transformer(table);
+    auto start = hclock::now();
+    for (uint64_t i = 0; i < count; i++) {
+        transformer.transform_line(log[i % log.size()]);
+    }
+    double seconds = seconds_since(start);
+    return {"transform_output", "line", count, seconds};
+}
+
+/**
+ * Runs the headless top model until the packets are delivered. The
+ * run is timed without the profiler, and the transitions of the
+ * same run are counted by running it again with the profiler.
+ * @param packets number of packets to send
+ * @param results results the run and its transitions are added to
+ */
+void bench_top_model(uint64_t packets, vector<bench_result> &results) {
+    ofstream input(BENCH_INPUT_FILE_PATH);
+    input << "00:00:10:000 " << packets << endl;
+    input.close();
+    TIME until({static_cast<int>(packets / 30 + 1)});
+
+    auto start = hclock::now();
+    abp_top_model<TIME> model = make_abp_top_model<TIME>(BENCH_INPUT_FILE_PATH);
+    cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger> r(model.top, {0});
+    r.run_until(until);
+    double seconds = seconds_since(start);
+    uint64_t delivered = collect_abp_results(model, until).packets_delivered;
+
+    profile_registry::instance().clear();
+    {
+        abp_top_model<TIME> profiled_model = make_abp_top_model<TIME>(BENCH_INPUT_FILE_PATH,
+                                                                      DEFAULT_RANDOM_SEED,
+                                                                      abp_parameters<TIME>(),
+                                                                      true);
+        cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger>
+            profiled_runner(profiled_model.top, {0});
+        profiled_runner.run_until(until);
+    }
+    uint64_t transitions = profile_registry::instance().total_calls(PROFILE_INTERNAL) +
+                           profile_registry::instance().total_calls(PROFILE_EXTERNAL) +
+                           profile_registry::instance().total_calls(PROFILE_CONFLUENCE);
+    profile_registry::instance().clear();
+    remove(BENCH_INPUT_FILE_PATH);
+
+    string name = "top model " + to_string(packets) + " packets";
+    results.push_back({name, "transition", transitions, seconds});
+    results.push_back({name, "packet", delivered, seconds});
+}
+
+/**
+ * Writes text as a JSON string
+ */
+string json_string(const string &text) {
+    string json = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+        }
+        json += c;
+    }
+    return json + "\"";
+}
+
+/**
+ * Writes the results as JSON
+ * @param file_path file written
+ * @param results results of the benchmarks
+ */
+void write_json(const char *file_path, const vector<bench_result> &results) {
+    ofstream json(file_path);
+    json << "{\n  \"suite\": \"abp\",\n  \"time\": \"NDTime\",\n  \"seed\": "
+         << DEFAULT_RANDOM_SEED << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench_result &r = results[i];
+        json << "    {\"name\": " << json_string(r.name) << ", \"unit\": "
+             << json_string(r.unit) << ", \"operations\": " << r.operations
+             << ", \"seconds\": " << r.seconds << ", \"per_second\": "
+             << (r.seconds > 0 ? r.operations / r.seconds : 0) << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+}
+
+/**
+ * Usage: BENCH_SUITE [--json FILE] [--operations N] [--max-packets N]
+ */
+int main(int argc, char **argv) {
+    const char *json_file = BENCH_JSON_FILE_PATH;
+    uint64_t operations = BENCH_OPERATIONS;
+    uint64_t max_packets = BENCH_MAX_PACKETS;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 == argc) {
+            cout << "usage: " << argv[0]
+                 << " [--json FILE] [--operations N] [--max-packets N]" << endl;
+            return 1;
+        }
+        if (arg == "--json") {
+            json_file = argv[++i];
+        } else if (arg == "--operations") {
+            operations = max(strtoull(argv[++i], nullptr, 0), 1ULL);
+        } else if (arg == "--max-packets") {
+            max_packets = strtoull(argv[++i], nullptr, 0);
+        } else {
+            cout << "usage: " << argv[0]
+                 << " [--json FILE] [--operations N] [--max-packets N]" << endl;
+            return 1;
+        }
+    }
+
+    vector<bench_result> results;
+    results.push_back(bench_sender(operations));
+    results.push_back(bench_receiver(operations));
+    results.push_back(bench_subnet(operations));
+    results.push_back(bench_message_bags(operations));
+    results.push_back(bench_parser(operations));
+    results.push_back(bench_transform(operations));
+    for (uint64_t packets = 1000; packets <= max_packets; packets *= 10) {
+        bench_top_model(packets, results);
+    }
+
+    cout << left << setw(34) << "benchmark" << right << setw(14) << "operations"
+         << setw(12) << "seconds" << setw(16) << "per second" << endl;
+    for (const bench_result &r : results) {
+        cout << left << setw(34) << r.name << right << setw(14) << r.operations
+             << setw(12) << r.seconds << setw(16) << r.operations / r.seconds
+             << " " << r.unit << "s" << endl;
+    }
+    write_json(json_file, results);
+    cout << "Results written to " << json_file << endl;
+    return 0;
+}
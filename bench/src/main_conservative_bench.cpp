@@ -0,0 +1,128 @@
+/**  \brief This main file benchmarks the conservative run of many flows
+ *
+ * Runs the same flows, each one sending the given number of packets
+ * over subnets with a minimum delay of 2 seconds, first with the
+ * sequential runner of the multi-flow top model, then as the two
+ * logical processes of the conservative run. Checks that both runs
+ * give the same results and prints the time of each one and the
+ * speedup of the conservative run.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../include/top_model/abp_conservative.hpp"
+#include "../../include/top_model/abp_flows.hpp"
+
+//define input file, default sizes of the benchmark and minimum delay of the subnets
+#define BENCH_INPUT_FILE_PATH "bin/bench/conservative_bench_input.txt"
+#define BENCH_FLOWS 500
+#define BENCH_PACKETS 100
+#define BENCH_DELAY_MIN 2.0
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Seconds elapsed since start
+ */
+double seconds_since(hclock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::duration<double,
+           std::ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * @return true if both runs sent, delivered, retransmitted, received
+ * again, lost and dropped the same packets at the same times
+ */
+bool same_results(const abp_results<TIME> &a, const abp_results<TIME> &b) {
+    return a.packets_delivered == b.packets_delivered &&
+           a.packets_sent == b.packets_sent &&
+           a.retransmissions == b.retransmissions &&
+           a.duplicates == b.duplicates &&
+           a.packets_lost == b.packets_lost &&
+           a.packets_dropped == b.packets_dropped &&
+           a.last_delivery_time == b.last_delivery_time;
+}
+
+/**
+ * Usage: CONSERVATIVE_BENCH [--flows N] [--packets N] [--seed N]
+ */
+int main(int argc, char **argv) {
+    uint64_t flows = BENCH_FLOWS;
+    uint64_t packets = BENCH_PACKETS;
+    uint64_t seed = DEFAULT_RANDOM_SEED;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 == argc) {
+            cout << "usage: " << argv[0] << " [--flows N] [--packets N] [--seed N]" << endl;
+            return 1;
+        }
+        if (arg == "--flows") {
+            flows = max(strtoull(argv[++i], nullptr, 0), 1ULL);
+        } else if (arg == "--packets") {
+            packets = max(strtoull(argv[++i], nullptr, 0), 1ULL);
+        } else if (arg == "--seed") {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            cout << "usage: " << argv[0] << " [--flows N] [--packets N] [--seed N]" << endl;
+            return 1;
+        }
+    }
+
+    ofstream input(BENCH_INPUT_FILE_PATH);
+    input << "00:00:10:000 " << packets << endl;
+    input.close();
+    abp_sweep_point parameters = to_sweep_point(abp_parameters<TIME>());
+    parameters[DELAY_MIN] = BENCH_DELAY_MIN;
+    vector<abp_flow_group> groups = {{flows, parameters}};
+    TIME until("04:00:00:000");
+
+    auto start = hclock::now();
+    abp_flows_model<TIME> sequential = make_abp_flows_model<TIME>(BENCH_INPUT_FILE_PATH,
+                                                                  groups, seed);
+    cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger> r(sequential.top, {0});
+    r.run_until(until);
+    double sequential_seconds = seconds_since(start);
+    abp_results<TIME> sequential_results = collect_abp_flows_results(sequential, until);
+
+    start = hclock::now();
+    abp_conservative_model<TIME> conservative = make_abp_conservative_model<TIME>(BENCH_INPUT_FILE_PATH,
+                                                                                  groups, seed);
+    uint64_t windows = run_abp_conservative(conservative, until);
+    double conservative_seconds = seconds_since(start);
+    abp_flows_model<TIME> conservative_flows;
+    conservative_flows.flows = conservative.flows;
+    abp_results<TIME> conservative_results = collect_abp_flows_results(conservative_flows, until);
+    remove(BENCH_INPUT_FILE_PATH);
+
+    cout << flows << " flows of " << packets << " packets, minimum delay "
+         << BENCH_DELAY_MIN << "sec" << endl;
+    cout << left << setw(16) << "run" << right << setw(12) << "seconds"
+         << setw(12) << "packets" << setw(12) << "windows" << endl;
+    cout << left << setw(16) << "sequential" << right << setw(12) << sequential_seconds
+         << setw(12) << sequential_results.packets_delivered << setw(12) << "-" << endl;
+    cout << left << setw(16) << "conservative" << right << setw(12) << conservative_seconds
+         << setw(12) << conservative_results.packets_delivered << setw(12) << windows << endl;
+    cout << "Speedup: " << sequential_seconds / conservative_seconds << endl;
+
+    if (!same_results(sequential_results, conservative_results)) {
+        cout << "The results of the conservative run differ from the sequential ones" << endl;
+        return 1;
+    }
+    cout << "Same results in both runs" << endl;
+    return 0;
+}
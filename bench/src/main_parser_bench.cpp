@@ -0,0 +1,153 @@
+/**  \brief This main file benchmarks the input parser of iestream_input
+ *
+ * This file writes a synthetic control input of several million
+ * lines and reads it back, with the stream extraction the parser
+ * used to do, ending with an exception, and with the memory mapped
+ * parser, for NDTime and for the integer tick time, and the same
+ * inputs from a binary event file. It prints the time per line of each.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../lib/vendor/iestream.hpp"
+#include "../../include/data_structures/message.hpp"
+#include "../../include/data_structures/tick_time.hpp"
+
+//define default input file and number of lines
+#define BENCH_INPUT_FILE_PATH "bin/bench/parser_bench_input.txt"
+#define BENCH_BINARY_INPUT_FILE_PATH "bin/bench/parser_bench_input.bin"
+#define BENCH_LINES 5000000
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+
+/**
+ * Writes lines "HH:MM:SS:mmm N", one millisecond apart
+ * @param file_path file written
+ * @param lines number of lines
+ */
+void write_input(const char *file_path, long lines) {
+    FILE *file = fopen(file_path, "w");
+    for (long i = 0; i < lines; i++) {
+        fprintf(file, "%02ld:%02ld:%02ld:%03ld %ld\n", i / 3600000, i / 60000 % 60, 
+                i / 1000 % 60, i % 1000, i % 100);
+    }
+    fclose(file);
+}
+
+/**
+ * Writes the same inputs as write_input as a binary event file
+ * @param file_path file written
+ * @param lines number of records
+ */
+void write_binary_input(const char *file_path, long lines) {
+    iestream_binary_header header;
+    memcpy(header.magic, IESTREAM_BINARY_MAGIC, sizeof(header.magic));
+    header.version = IESTREAM_BINARY_VERSION;
+    header.record_size = sizeof(int64_t) + MESSAGE_RECORD_SIZE;
+    header.record_count = lines;
+    char header_bytes[IESTREAM_BINARY_HEADER_SIZE];
+    header.encode(header_bytes);
+    FILE *file = fopen(file_path, "wb");
+    fwrite(header_bytes, sizeof(header_bytes), 1, file);
+    char record[sizeof(int64_t) + MESSAGE_RECORD_SIZE];
+    for (long i = 0; i < lines; i++) {
+        store_little_endian(uint64_t(i), record, sizeof(int64_t));
+        encode_input(message_t(i % 100), record + sizeof(int64_t));
+        fwrite(record, sizeof(record), 1, file);
+    }
+    fclose(file);
+}
+
+/**
+ * Reads the file as the parser used to, with ifstream >> and
+ * an exception at the end of the file
+ * @return lines read
+ */
+template<typename TIME>
+long read_stream(const char *file_path) {
+    ifstream file(file_path);
+    long lines = 0;
+    try {
+        for (;;) {
+            TIME time;
+            message_t msg;
+            if (file.eof()) throw std::exception();
+            file >> time;
+            file >> msg;
+            if (!file) throw std::exception();
+            lines++;
+        }
+    } catch (std::exception &e) {
+    }
+    return lines;
+}
+
+/**
+ * Reads the file with the memory mapped parser
+ * @return lines read
+ */
+template<typename TIME>
+long read_mapped(const char *file_path) {
+    Parser<TIME, message_t> parser(file_path);
+    std::pair<TIME, message_t> timed_input;
+    long lines = 0;
+    while (parser.next_timed_input(timed_input)) {
+        lines++;
+    }
+    return lines;
+}
+
+/**
+ * Times a reader and prints its time per line
+ * @return nanoseconds per line
+ */
+template<typename READER>
+double measure(const char *name, READER reader, long expected) {
+    auto start = hclock::now();
+    long lines = reader();
+    double ns = std::chrono::duration_cast<std::chrono::duration<double, 
+                std::nano>>(hclock::now() - start).count() / max(lines, 1L);
+    cout << left << setw(22) << name << right << setw(12) << ns << " ns/line" 
+         << (lines == expected ? "" : "  (lines missing)") << endl;
+    return ns;
+}
+
+/**
+ * Usage: PARSER_BENCH [lines]
+ */
+int main(int argc, char **argv) {
+    long lines = argc > 1 ? atol(argv[1]) : BENCH_LINES;
+    if (lines < 1) {
+        lines = 1;
+    }
+    const char *file_path = BENCH_INPUT_FILE_PATH;
+    write_input(file_path, lines);
+    cout << "Input: " << lines << " lines" << endl;
+
+    double nd_stream = measure("NDTime stream", [&]{ return read_stream<NDTime>(file_path); }, lines);
+    double nd_mapped = measure("NDTime mapped", [&]{ return read_mapped<NDTime>(file_path); }, lines);
+    double tick_stream = measure("TickTime stream", [&]{ return read_stream<TickTime>(file_path); }, lines);
+    double tick_mapped = measure("TickTime mapped", [&]{ return read_mapped<TickTime>(file_path); }, lines);
+    cout << "Speedup NDTime: " << nd_stream / nd_mapped << "x, TickTime: " 
+         << tick_stream / tick_mapped << "x" << endl;
+
+    const char *binary_file_path = BENCH_BINARY_INPUT_FILE_PATH;
+    write_binary_input(binary_file_path, lines);
+    double tick_binary = measure("TickTime binary", [&]{ return read_mapped<TickTime>(binary_file_path); }, lines);
+    cout << "Speedup binary over text: " << tick_mapped / tick_binary << "x" << endl;
+    remove(file_path);
+    remove(binary_file_path);
+    return 0;
+}
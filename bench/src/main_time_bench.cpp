@@ -0,0 +1,168 @@
+/**  \brief This main file benchmarks NDTime against TickTime
+ *
+ * This file measures the time operations done by the cadmium
+ * engine and the atomic models (sums, differences, comparisons,
+ * infinity and construction from fields or text) with NDTime
+ * and with the integer tick time, then runs the ABP top model
+ * headless with each of them, and prints the time per operation
+ * and per run of each type.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../include/data_structures/tick_time.hpp"
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/top_model/abp_replications.hpp"
+
+//define default input file and number of operations and runs
+#define BENCH_INPUT_FILE_PATH "data/top_model/input_abp_1.txt"
+#define BENCH_OPERATIONS 1000000
+#define BENCH_RUNS 100
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+
+/**
+ * Nanoseconds elapsed since start, divided by the count of operations
+ */
+double ns_per_operation(hclock::time_point start, long count) {
+    return std::chrono::duration_cast<std::chrono::duration<double, 
+           std::nano>>(hclock::now() - start).count() / count;
+}
+
+/**
+ * Engine like loop: finds the next time among the models, advances
+ * the clock to it and takes the elapsed time of each model
+ * @param count number of iterations
+ * @return nanoseconds per iteration
+ */
+template<typename TIME>
+double bench_arithmetic(long count) {
+    vector<TIME> next = {TIME({0, 0, 3}), TIME({0, 0, 10}), 
+                         TIME({0, 0, 20}), std::numeric_limits<TIME>::infinity()};
+    TIME clock;
+    long checksum = 0;
+    auto start = hclock::now();
+    for (long i = 0; i < count; i++) {
+        TIME t = std::numeric_limits<TIME>::infinity();
+        for (const TIME &n : next) {
+            if (n < t) {
+                t = n;
+            }
+        }
+        clock += t;
+        for (TIME &n : next) {
+            if (n != std::numeric_limits<TIME>::infinity()) {
+                n = n - t + TIME({0, 0, 1});
+                checksum += n == t;
+            }
+        }
+    }
+    double ns = ns_per_operation(start, count);
+    if (checksum < 0) {
+        cout << clock << endl;
+    }
+    return ns;
+}
+
+/**
+ * Builds times from fields, as the subnets do for their delay
+ * @param count number of times built
+ * @return nanoseconds per time
+ */
+template<typename TIME>
+double bench_fields(long count) {
+    TIME total;
+    auto start = hclock::now();
+    for (long i = 0; i < count; i++) {
+        total += TIME({0, 0, static_cast<int>(i % 7)});
+    }
+    double ns = ns_per_operation(start, count);
+    if (total < TIME()) {
+        cout << total << endl;
+    }
+    return ns;
+}
+
+/**
+ * Builds times from text, as the models and the input files do
+ * @param count number of times built
+ * @return nanoseconds per time
+ */
+template<typename TIME>
+double bench_text(long count) {
+    TIME total;
+    auto start = hclock::now();
+    for (long i = 0; i < count; i++) {
+        total += TIME("00:00:10:000");
+    }
+    double ns = ns_per_operation(start, count);
+    if (total < TIME()) {
+        cout << total << endl;
+    }
+    return ns;
+}
+
+/**
+ * Runs the top model headless
+ * @param input_file input data control file
+ * @param runs number of runs
+ * @return nanoseconds per run
+ */
+template<typename TIME>
+double bench_runs(const char *input_file, long runs) {
+    auto start = hclock::now();
+    for (long i = 0; i < runs; i++) {
+        run_replication<TIME>(input_file, DEFAULT_RANDOM_SEED + i, 
+                              abp_parameters<TIME>(), TIME("04:00:00:000"));
+    }
+    return ns_per_operation(start, runs);
+}
+
+/**
+ * Prints a row of the results
+ * @param name name of the measure
+ * @param nd nanoseconds with NDTime
+ * @param tick nanoseconds with TickTime
+ */
+void report(const char *name, double nd, double tick) {
+    cout << left << setw(22) << name << right << setw(16) << nd 
+         << setw(16) << tick << setw(12) << nd / tick << "x" << endl;
+}
+
+/**
+ * Usage: TIME_BENCH [input file] [operations] [runs]
+ */
+int main(int argc, char **argv) {
+    const char *input_file = argc > 1 ? argv[1] : BENCH_INPUT_FILE_PATH;
+    long operations = argc > 2 ? atol(argv[2]) : BENCH_OPERATIONS;
+    long runs = argc > 3 ? atol(argv[3]) : BENCH_RUNS;
+    if (operations < 1) {
+        operations = 1;
+    }
+    if (runs < 1) {
+        runs = 1;
+    }
+
+    cout << left << setw(22) << "ns per operation" << right << setw(16) << "NDTime" 
+         << setw(16) << "TickTime" << setw(13) << "speedup" << endl;
+    report("engine step", bench_arithmetic<NDTime>(operations), 
+           bench_arithmetic<TickTime>(operations));
+    report("time from fields", bench_fields<NDTime>(operations), 
+           bench_fields<TickTime>(operations));
+    report("time from text", bench_text<NDTime>(operations), 
+           bench_text<TickTime>(operations));
+    report("headless run", bench_runs<NDTime>(input_file, runs), 
+           bench_runs<TickTime>(input_file, runs));
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**  \brief This main file benchmarks traced against headless runs
+ *
+ * This file runs the ABP top model several times on the same
+ * input file, with the message and global time loggers used by
+ * the simulator writing the log file and its table from the writer
+ * thread, with the same loggers writing on the simulation thread
+ * and with a null logger, and prints the wall-clock time of each
+ * mode.
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/transform_output/transform_output.hpp"
+
+//define default input, output file and number of repetitions
+#define BENCH_INPUT_FILE_PATH "data/top_model/input_abp_1.txt"
+#define BENCH_OUTPUT_FILE_PATH "bin/bench/trace_bench_output.txt"
+#define BENCH_TRANSFORM_OUTPUT_FILE_PATH "bin/bench/trace_bench_output_transform.txt"
+#define BENCH_REPETITIONS 10
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Log file and table of the traced runs
+ */
+static transform_sink out_data;
+
+/**
+ * Sink provider returning the stream of the traced runs
+ */
+struct oss_sink_provider{
+    static std::ostream& sink() {
+        return out_data.stream();
+    }
+};
+
+/**
+ * Same loggers as the ABP simulator
+ */
+using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages, 
+                     cadmium::dynamic::logger::formatter<TIME>, 
+                     oss_sink_provider>;
+using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time, 
+                    cadmium::dynamic::logger::formatter<TIME>, 
+                    oss_sink_provider>;
+using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+
+/**
+ * Builds and runs the top model once with the given logger
+ * @param input_file input data control file
+ * @return wall-clock seconds taken by the run
+ */
+template<typename LOGGER>
+double run_once(const char *input_file) {
+    auto start = hclock::now();
+    abp_top_model<TIME> model = make_abp_top_model<TIME>(input_file);
+    cadmium::dynamic::engine::runner<TIME, LOGGER> r(model.top, {0});
+    r.run_until(TIME("04:00:00:000"));
+    return std::chrono::duration_cast<std::chrono::duration<double, 
+           std::ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Runs the top model once writing the log file and its table,
+ * including in the time the writing left when the run ends
+ * @param input_file input data control file
+ * @param asynchronous true to write from the writer thread
+ * @return wall-clock seconds taken by the run and the writing
+ */
+double traced_once(const char *input_file, bool asynchronous) {
+    auto start = hclock::now();
+    out_data.open(BENCH_TRANSFORM_OUTPUT_FILE_PATH, BENCH_OUTPUT_FILE_PATH, asynchronous);
+    run_once<logger_top>(input_file);
+    out_data.close();
+    return std::chrono::duration_cast<std::chrono::duration<double, 
+           std::ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Prints the mean and the minimum of the measured times
+ * @param name name of the mode
+ * @param times seconds taken by each run
+ * @return mean of the times
+ */
+double report(const char *name, const vector<double> &times) {
+    double total = 0;
+    for (double t : times) {
+        total += t;
+    }
+    double mean = total / times.size();
+    cout << name << ": mean " << mean << "sec, min " 
+         << *std::min_element(times.begin(), times.end()) 
+         << "sec over " << times.size() << " runs" << endl;
+    return mean;
+}
+
+/**
+ * Usage: TRACE_BENCH [input file] [repetitions]
+ */
+int main(int argc, char **argv) {
+    const char *input_file = argc > 1 ? argv[1] : BENCH_INPUT_FILE_PATH;
+    int repetitions = argc > 2 ? atoi(argv[2]) : BENCH_REPETITIONS;
+    if (repetitions < 1) {
+        repetitions = 1;
+    }
+
+    vector<double> traced, synchronous, headless;
+    for (int i = 0; i < repetitions; i++) {
+        traced.push_back(traced_once(input_file, true));
+        synchronous.push_back(traced_once(input_file, false));
+        headless.push_back(run_once<cadmium::logger::not_logger>(input_file));
+    }
+
+    double traced_mean = report("Traced", traced);
+    double synchronous_mean = report("Traced synchronous", synchronous);
+    double headless_mean = report("Headless", headless);
+    cout << "Speedup of the writer thread: " << synchronous_mean / traced_mean << "x" << endl;
+    cout << "Speedup: " << traced_mean / headless_mean << "x" << endl;
+    return 0;
+}
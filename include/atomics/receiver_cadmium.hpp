@@ -10,6 +10,11 @@
 * the acknowledgement, once it is sent it go to passive 
 * state again. The receiver has a constant delay
 *
+* The receiver counts the packets it receives and, among them, the
+* duplicates: the packets with the number and the alternating bit of
+* the packet received before, sent again because their acknowledgement
+* was lost or late.
+*
 * Cristina Ruiz Martin
 * ARSLab - Carleton University
 *
@@ -59,21 +64,32 @@ class Receiver{
     TIME PREPARATION_TIME; /**< PREPARATION_TIME is a constant that contains the time delay from acknowledge to output. */ //!< Time constant delay 
     /** 
     * Default constructor for Receiver class.
+    * Preparation time of 10 seconds
+    */
+    Receiver() noexcept : Receiver(TIME("00:00:10")) {}
+
+    /** 
+    * Constructor for Receiver class.
     * Initializes  delay constant, state acknowledgement number
     * and sending setting to false
+    * @param preparation_time time taken to send back the acknowledgement
     */
-    Receiver() noexcept{
-        PREPARATION_TIME = TIME("00:00:10");
-        state.ack_num = 0;
+    Receiver(TIME preparation_time) noexcept{
+        PREPARATION_TIME = preparation_time;
+        state.ack = message_t(0, 0);
         state.sending = false;
+        state.packets_received = 0;
+        state.duplicates = 0;
     }
             
     /**
      * Structure state definition which holds acknowledge number and receiver state.
      */
     struct state_type{
-        int ack_num;    /**< Alternating bit retrieved from the message and acknowledgement number. */ //!< Acknowledgement number
+        message_t ack;  /**< Packet number and alternating bit retrieved from the message to acknowledge. */ //!< Acknowledgement
         bool sending;   /**< State of the reciver passive or active */  //!< Sending state.
+        int64_t packets_received; /**< Packets received, without the duplicates */
+        int64_t duplicates;       /**< Packets received again */
     };  state_type state;
 
     // ports definition
@@ -94,7 +110,9 @@ class Receiver{
     * it asserts sending state to false and concatenate the message
     * that only one message is expected per time unit. 
     * It then sets the acknowledge to the message value and 
-    * sets the sending state to true.
+    * sets the sending state to true. A packet with the number and
+    * the alternating bit of the last packet acknowledged is counted
+    * as a duplicate.
     * @param e of type time 
     * @param mbs of type message bags
     */
@@ -105,7 +123,13 @@ class Receiver{
             assert(false && "one message per time uniti");
         }
         for(const auto &x : get_messages<typename defs::in>(mbs)){
-            state.ack_num = static_cast < int > (x.value);
+            if (state.packets_received > 0 && x.packet_num == state.ack.packet_num && 
+                x.alt_bit == state.ack.alt_bit){
+                state.duplicates++;
+            } else{
+                state.packets_received++;
+            }
+            state.ack = message_t(x.packet_num, x.alt_bit);
             state.sending = true;
         }                            
     }
@@ -124,16 +148,14 @@ class Receiver{
 
 
     /**
-    * Output function sends the acknowledgement number to the output port.
-    * The ouput value is calculated as the reminder of after
-    * dividing acknowledgement number by 10. 
+    * Output function sends the acknowledgement to the output port.
+    * The ouput holds the packet number and the alternating bit
+    * of the packet received. 
     * @return message bags
     */
     typename make_message_bags<output_ports>::type output() const {
         typename make_message_bags<output_ports>::type bags;
-        message_t out;              
-        out.value = state.ack_num % 10;
-        get_messages<typename defs::out>(bags).push_back(out);
+        get_messages<typename defs::out>(bags).push_back(state.ack);
         return bags;
     }
 
@@ -163,7 +185,7 @@ class Receiver{
 
     friend std::ostringstream& operator<<(std::ostringstream& os, 
                                           const typename Receiver<TIME>::state_type& i){
-        os << "ack_num: " << i.ack_num; 
+        os << "ack: " << i.ack; 
         return os;
     }
 };     
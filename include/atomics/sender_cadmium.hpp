@@ -11,6 +11,15 @@
 * the next packet. When there are no more packets to send, 
 * the sender will go again to the passive phase.
 *
+* The sender measures the latency of each packet, from its first
+* transmission to its acknowledgement, and the number of times it
+* was sent again, in histograms of its state, and counts every
+* transmission.
+*
+* With an adaptive timeout the waiting time is not constant: it is
+* estimated from the round trip times of the packets acknowledged
+* and doubled by each timeout, starting from the timeout given.
+*
 * Cristina Ruiz Martin
 * ARSLab - Carleton University
 *
@@ -35,6 +44,10 @@
 #include <random>
 
 #include "../data_structures/message.hpp"
+#include "../data_structures/time_conversion.hpp"
+#include "../metrics/latency_histogram.hpp"
+#include "../metrics/rtt_estimator.hpp"
+#include "../../lib/vendor/iestream.hpp"
 
 using namespace cadmium;
 using namespace std;
@@ -63,19 +76,40 @@ class Sender{
     //Parameters to be overwriten when instantiating the atomic model
     TIME   PREPARATION_TIME; /**< PREPARATION_TIME is a constant that contains the time delay from acknowledge to output. */ //!< Time constant delay
     TIME   timeout;          /**< timeout is a onstant that contains time delay from output to acknowledge */ //!< Time constant delay
+    bool   adaptive_timeout; /**< The timeout is estimated from the round trip times, from timeout */
    
     /** 
-    * Default constructor for Receiver class.
+    * Default constructor for Sender class.
+    * Preparation time of 10 seconds and timeout of 20 seconds
+    */
+    Sender() noexcept : Sender(TIME("00:00:10"), TIME("00:00:20")) {}
+
+    /** 
+    * Constructor for Sender class.
     * Initializes  delay constant, timeout constant 
     * set alternetbit state to 0, next internal state  to 0
     * and set model active state to false
+    * @param preparation_time time taken to prepare a packet
+    * @param timeout_time time waited for an acknowledgement,
+    *                     the first one with an adaptive timeout
+    * @param adaptive true to estimate the timeout from the round trip times
     */
-    Sender() noexcept{
-        PREPARATION_TIME = TIME("00:00:10");
-        timeout = TIME("00:00:20");
+    Sender(TIME preparation_time, TIME timeout_time, bool adaptive = false) noexcept{
+        PREPARATION_TIME = preparation_time;
+        timeout = timeout_time;
+        adaptive_timeout = adaptive;
+        state.rtt = rtt_estimator(time_to_milliseconds(timeout_time));
+        state.rto = adaptive ? time_from_milliseconds<TIME>(state.rtt.timeout_ms()) : timeout_time;
         state.alt_bit = 0;
         state.next_internal = std::numeric_limits<TIME>::infinity();
         state.model_active = false;
+        state.packets_delivered = 0;
+        state.packets_sent = 0;
+        state.retransmissions = 0;
+        state.clock = TIME();
+        state.last_delivery_time = TIME();
+        state.packet_sent = false;
+        state.packet_retransmissions = 0;
     }
             
     /**
@@ -83,12 +117,24 @@ class Sender{
      */
     struct state_type{
         bool ack;
-        int packet_num;
-        int total_packet_num;
+        int64_t packet_num;
+        int64_t total_packet_num;
         int alt_bit;
         bool sending;
         bool model_active;
         TIME next_internal;
+        int64_t packets_delivered; /**< Packets whose expected acknowledgement was received */
+        int64_t packets_sent;      /**< Transmissions, the first ones and the retransmissions */
+        int64_t retransmissions;   /**< Packets sent again after the timeout expired */
+        TIME clock;              /**< Simulation time of the last transition */
+        TIME last_delivery_time; /**< Simulation time of the last delivered packet */
+        bool packet_sent;        /**< The current packet was sent at least once */
+        TIME packet_sent_time;   /**< Simulation time of the first transmission of the current packet */
+        int64_t packet_retransmissions;   /**< Retransmissions of the current packet */
+        latency_histogram latency;        /**< Milliseconds from the first transmission to the acknowledgement */
+        latency_histogram packet_retransmission_counts; /**< Retransmissions of each delivered packet */
+        rtt_estimator rtt;       /**< Estimator of the adaptive timeout */
+        TIME rto;                /**< Time waited for the acknowledgement of the packet sent */
     }; state_type state;
 
     // ports definition
@@ -103,11 +149,21 @@ class Sender{
     /**
     * Internal transition function that check acknowledgement state
     * and sending state so it sets the next state based on the current state.
+    * The clock is advanced by the time advance that triggered it, each
+    * packet sent is counted and a packet sent again after the timeout
+    * is counted as a retransmission when it is sent, not when the
+    * timeout expires, as its acknowledgement may still arrive while
+    * it is prepared again.
+    * The time of the first transmission of a packet is kept to measure
+    * its latency. An adaptive timeout is doubled when it expires.
     */
     void internal_transition(){
+        state.clock += state.next_internal;
         if (state.ack){
             if (state.packet_num < state.total_packet_num){
                 state.packet_num ++;
+                state.packet_sent = false;
+                state.packet_retransmissions = 0;
                 state.ack = false;
                 state.alt_bit = (state.alt_bit + 1) % 2;
                 state.sending = true;
@@ -119,10 +175,22 @@ class Sender{
             }
         } else{
             if(state.sending){
+                if (!state.packet_sent){
+                    state.packet_sent = true;
+                    state.packet_sent_time = state.clock;
+                } else{
+                    state.retransmissions ++;
+                    state.packet_retransmissions ++;
+                }
+                state.packets_sent ++;
                 state.sending = false;
                 state.model_active = true;
-                state.next_internal = timeout;
+                state.next_internal = state.rto;
             } else{
+                if (adaptive_timeout){
+                    state.rtt.back_off();
+                    state.rto = time_from_milliseconds<TIME>(state.rtt.timeout_ms());
+                }
                 state.sending = true;
                 state.model_active = true;
                 state.next_internal = PREPARATION_TIME;    
@@ -132,27 +200,34 @@ class Sender{
 
     /**
     * External transition function that extract the messages: 
-    * if the number of messages is greater than 1
+    * if the number of messages of a port is greater than 1
     * it asserts sending state to false and concatenate the message
-    * that only one message is expected per time unit. 
+    * that only one message is expected per time unit and port. 
+    * A control message and an acknowledgement may arrive together
+    * as the delays of the subnets are random. 
     * It then set the next state based on the current state
     * It also chceck the next internal transtion is not equal to infinity
     * it sets the next internal state -e
+    * The expected acknowledgement counts the packet as delivered and
+    * records its latency and retransmissions. Its latency is a round
+    * trip time of the adaptive timeout if it was only sent once.
     * @param e of type time 
     * @param mbs of type message bags
     */
     void external_transition(TIME e, 
                              typename make_message_bags<input_ports>::type mbs){ 
-
-        if((get_messages<typename defs::controlIn>(mbs).size()+
-            get_messages<typename defs::ackIn>(mbs).size())>1){
+        state.clock += e;
+        if(get_messages<typename defs::controlIn>(mbs).size()>1 ||
+           get_messages<typename defs::ackIn>(mbs).size()>1){
             assert(false && "one message per time uniti");
         }
         for(const auto &x : get_messages<typename defs::controlIn>(mbs)){
             if(state.model_active == false){
-                state.total_packet_num = static_cast < int > (x.value);
+                state.total_packet_num = x.packet_num;
                 if (state.total_packet_num > 0){
                     state.packet_num = 1;
+                    state.packet_sent = false;
+                    state.packet_retransmissions = 0;
                     state.ack = false;
                     state.sending = true;
                     state.alt_bit = state.packet_num % 2;  //set initial alt_bit
@@ -167,10 +242,22 @@ class Sender{
         }
         for(const auto &x : get_messages<typename defs::ackIn>(mbs)){
             if(state.model_active == true){ 
-                if (state.alt_bit == static_cast < int > (x.value)){
+                if (state.alt_bit == x.alt_bit){
+                    if (!state.ack){
+                        int64_t latency = time_to_milliseconds(state.clock - 
+                                                               state.packet_sent_time);
+                        state.packets_delivered ++;
+                        state.last_delivery_time = state.clock;
+                        state.latency.record(latency);
+                        state.packet_retransmission_counts.record(state.packet_retransmissions);
+                        if (adaptive_timeout && state.packet_retransmissions == 0){
+                            state.rtt.sample(latency);
+                            state.rto = time_from_milliseconds<TIME>(state.rtt.timeout_ms());
+                        }
+                    }
                     state.ack = true;
                     state.sending = false;
-                    state.next_internal = TIME("00:00:00");
+                    state.next_internal = TIME();
                 } else{
                     if(state.next_internal != std::numeric_limits<TIME>::infinity()){
                         state.next_internal = state.next_internal - e;
@@ -195,22 +282,20 @@ class Sender{
 
     /**
     * Output function sends the packet number to the output port.
-    * The ouput value is calculated as packet number *10  + alternating bit
+    * The data message holds the packet number and the alternating bit,
     * the ouput is pushed to message bags. If Acknolwegement state is true
-    * set output value to alternatbit state and push it to message bag
+    * the packet acknowledged and its alternating bit are pushed to message bag
     * @return Message bags
     */
     typename make_message_bags<output_ports>::type output() const {
         typename make_message_bags<output_ports>::type bags;
-        message_t out;
         if (state.sending){
-            out.value = state.packet_num * 10 + state.alt_bit;
+            message_t out(state.packet_num, state.alt_bit);
             get_messages<typename defs::dataOut>(bags).push_back(out);
-            out.value = state.packet_num;
-            get_messages<typename defs::packetSentOut>(bags).push_back(out);
+            get_messages<typename defs::packetSentOut>(bags).push_back(message_t(state.packet_num));
         } else{
             if(state.ack){
-                out.value = state.alt_bit;
+                message_t out(state.packet_num, state.alt_bit);
                 get_messages<typename defs::ackReceivedOut>(bags).push_back(out);
             }
         }   
@@ -226,8 +311,8 @@ class Sender{
     }
 
     /**
-    * Friend is a function that outputs packet number and total
-    * packet number to ostring stream.
+    * Friend is a function that outputs packet number, total
+    * packet number and timeout to ostring stream.
     * @param os the ostring stream
     * @param i structure state_type
     * @return os the ostring stream
@@ -235,7 +320,7 @@ class Sender{
     friend std::ostringstream& operator<<(std::ostringstream& os, 
                                           const typename Sender<TIME>::state_type& i){
         os << "packet_num: " << i.packet_num << " & total_packet_num: " <<
-        i.total_packet_num; 
+        i.total_packet_num << " & rto: " << i.rto; 
         return os;
     }
 };     
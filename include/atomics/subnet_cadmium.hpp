@@ -11,6 +11,29 @@
 * the acknowledgement with 95% probability, once it is sent it go to passive 
 * state again.
 *
+* Each subnet owns its random generator, seeded when it is
+* instantiated, and draws the fate and the delay of a packet
+* when it receives it. By default the losses are independent and the
+* delay is normal, rounded to whole seconds; the subnet can also be
+* given any loss model and delay distribution of channel_model.hpp,
+* with delays down to the millisecond.
+*
+* Without a queue, a packet received while another one is transmitted
+* replaces it. With a queue the subnet is a link: it transmits one
+* packet at a time, at its bandwidth, while the packets received
+* meanwhile wait in a FIFO of bounded capacity, and the packets that
+* find it full are dropped at its tail. A transmitted packet then
+* reaches the other end after its delay, while the next one is
+* transmitted, and never overtakes the packets sent before it. The
+* delivery time of a packet is known when it is received. The packets
+* are kept in a ring buffer, reserved when the subnet is built for the
+* most packets the link can carry at once: the ones waiting, the one
+* transmitted and the ones propagating. Those are bounded when the
+* delay is, constant or empirical, and the link has a bandwidth; with
+* other delays, without a bandwidth or with packets shorter than the
+* packet size, the ring doubles when it is full, up to the packets
+* received during the longest delay drawn, and then never again.
+*
 * Cristina Ruiz Martin
 * ARSLab - Carleton University
 *
@@ -36,6 +59,12 @@
 
 //updated relative path --Syed Omar
 #include "../data_structures/message.hpp"
+#include "../data_structures/ring_buffer.hpp"
+#include "../data_structures/time_conversion.hpp"
+#include "../random/random_generator.hpp"
+#include "../random/channel_model.hpp"
+#include "../metrics/latency_histogram.hpp"
+#include "../../lib/vendor/iestream.hpp"
 
 using namespace cadmium;
 using namespace std;
@@ -47,6 +76,21 @@ struct subnet_defs{
     struct out : public out_port<message_t> {};
     struct in : public in_port<message_t> {};
 };
+
+/**
+* Queue of a subnet and bandwidth of its link
+*/
+struct subnet_queue{
+    int64_t capacity = 0;      ///< Packets waiting to be transmitted at most, 0 for no queue
+    double bandwidth = 0;      ///< Bytes per second transmitted, 0 for no transmission time
+    int64_t packet_size = 1000; ///< Bytes of a packet without a payload length
+};
+/**
+* Largest number of packets reserved for the link of a subnet, the
+* ring of a link carrying more packets grows when it is full
+*/
+#define SUBNET_MAX_RESERVED_PACKETS 4096
+
 //This is a meta-model, it should be overloaded for declaring the "id" parameter
 template<typename TIME>
 class Subnet{
@@ -54,16 +98,99 @@ class Subnet{
     using defs=subnet_defs; 
     public:
     //Parameters to be overwriten when instantiating the atomic model
-           
+    subnet_queue QUEUE; /**< Capacity of the queue and bandwidth of the link */
+
     /** 
     * Default constructor for subnet class.
-    * Initializes state structure of transmiting  to false
-    * and index to zero
+    * Seeds the random generator with the default seed
+    */
+    Subnet() noexcept : Subnet(DEFAULT_RANDOM_SEED, 0) {}
+
+    /** 
+    * Constructor for subnet class seeding its random generator.
+    * Subnets built with the same seed must use different streams
+    * to draw independent numbers.
+    * @param seed seed of the random generator
+    * @param stream independent stream of the seed used by this subnet
     */
-    Subnet() noexcept{
+    Subnet(uint64_t seed, unsigned int stream) noexcept 
+        : Subnet(seed, stream, 0.95, 3.0, 1.0) {}
+
+    /** 
+    * Constructor for subnet class setting its parameters.
+    * @param seed seed of the random generator
+    * @param stream independent stream of the seed used by this subnet
+    * @param pass_probability probability of a packet to be passed
+    * @param delay_mean mean of the normal delay in seconds
+    * @param delay_stddev standard deviation of the normal delay in seconds
+    * @param delay_min minimum delay in seconds
+    */
+    Subnet(uint64_t seed, unsigned int stream, double pass_probability, 
+           double delay_mean, double delay_stddev, double delay_min = 0) noexcept 
+        : Subnet(random_generator(seed, stream), pass_probability, 
+                 delay_mean, delay_stddev, delay_min) {}
+
+    /** 
+    * Constructor for subnet class given its random generator, already
+    * moved to its stream, so many subnets can be built without jumping
+    * from the seed each time.
+    * @param generator random generator of this subnet
+    * @param pass_probability probability of a packet to be passed
+    * @param delay_mean mean of the normal delay in seconds
+    * @param delay_stddev standard deviation of the normal delay in seconds
+    * @param delay_min minimum delay in seconds
+    */
+    Subnet(const random_generator &generator, double pass_probability, 
+           double delay_mean, double delay_stddev, double delay_min = 0) noexcept 
+        : Subnet(generator, subnet_channel{bernoulli_loss{pass_probability}, 
+                                           normal_delay{std::normal_distribution<double>(delay_mean, 
+                                                                                         delay_stddev)}, 
+                                           delay_min}) {}
+
+    /** 
+    * Constructor for subnet class given its random generator, already
+    * moved to its stream, and its loss model and delay distribution.
+    * @param generator random generator of this subnet
+    * @param channel loss model, delay distribution, minimum delay
+    *                and resolution of the delays
+    * @param queue capacity of the queue and bandwidth of the link,
+    *              no queue by default
+    */
+    Subnet(const random_generator &generator, const subnet_channel &channel, 
+           const subnet_queue &queue = subnet_queue()) noexcept{
+        QUEUE = queue;
         state.transmiting = false;
         state.index = 0;
+        state.lost = 0;
+        state.pass = false;
+        state.generator = generator;
+        state.channel = channel;
+        state.clock = TIME();
+        state.link_free = TIME();
+        state.waiting = 0;
+        state.dropped = 0;
+        if (QUEUE.capacity > 0){
+            state.packets.reserve(reserved_packets());
+        }
     }
+
+    /**
+     * Packet carried by the link of a subnet with a queue
+     */
+    struct link_packet{
+        message_t packet; ///< Packet received
+        bool pass;        ///< The packet is not lost
+        TIME start;       ///< Time its transmission starts
+        TIME delivery;    ///< Time it reaches the other end
+
+        template<typename ARCHIVE>
+        void serialize(ARCHIVE &archive){
+            archive(packet);
+            archive(pass);
+            archive(start);
+            archive(delivery);
+        }
+    };
             
     /**
      * Structure state definition which contains state
@@ -71,8 +198,19 @@ class Subnet{
      */
     struct state_type{
         bool transmiting;
-        int packet;
+        message_t packet;
         int index;
+        int64_t lost;                                    ///< Packets dropped by this subnet
+        bool pass;                                       ///< The packet being transmitted is not lost
+        TIME delay;                                      ///< Delay of the packet being transmitted
+        random_generator generator;                      ///< Generator of this subnet
+        subnet_channel channel;                          ///< Loss model and delay distribution
+        TIME clock;                                      ///< Time of the last transition, with a queue
+        ring_buffer<link_packet> packets;                ///< Packets received and not delivered yet, with a queue
+        TIME link_free;                                  ///< Time the link ends transmitting the packets received
+        int64_t waiting;                                 ///< Packets at the back of packets not transmitted yet
+        int64_t dropped;                                 ///< Packets dropped because the queue was full
+        latency_histogram queue_depth;                   ///< Packets waiting found by each packet received
     }; state_type state;
     // Intalizing input and output ports
     using input_ports=std::tuple<typename defs::in>;
@@ -80,9 +218,22 @@ class Subnet{
 
     /**
     * Internal transition function that set transmitting state to
-    * state
+    * state and counts the packet if it was dropped. With a queue the
+    * first packet carried reaches the other end.
     */
     void internal_transition(){
+        if (QUEUE.capacity > 0){
+            state.clock = state.packets.front().delivery;
+            if (!state.packets.front().pass){
+                state.lost++;
+            }
+            state.packets.pop_front();
+            state.transmiting = !state.packets.empty();
+            return;
+        }
+        if (!state.pass){
+            state.lost++;
+        }
         state.transmiting = false;  
     }
 
@@ -91,8 +242,11 @@ class Subnet{
     * if the number of messages is greater than 1
     * it asserts transmitting state to false and concatenate the message
     * that only one message is expected per time unit. 
-    * It then sets the packet to the message value and 
-    * sets the transmitting state to true.
+    * It then sets the packet to the message value, draws
+    * whether it is passed and its delay, and 
+    * sets the transmitting state to true. With a queue the packet
+    * is queued instead, or dropped if the queue is full, and the
+    * delay is the time left to its delivery.
     * @param e of type time 
     * @param mbs of type message bags
     */
@@ -102,9 +256,20 @@ class Subnet{
         if(get_messages<typename defs::in>(mbs).size()>1){
             assert(false && "One message at a time");  
         }              
+        if (QUEUE.capacity > 0){
+            state.clock += e;
+            for (const auto &x : get_messages<typename defs::in>(mbs)){
+                enqueue(x);
+            }
+            return;
+        }
         for (const auto &x : get_messages<typename defs::in>(mbs)){
-            state.packet = static_cast < int > (x.value);
+            state.packet = x;
             state.transmiting = true; 
+            state.pass = state.channel.loss.pass(state.generator);
+            // a delay is never below the minimum delay, zero by default,
+            // draws below it are clipped
+            state.delay = time_from_milliseconds<TIME>(state.channel.draw_delay_ms(state.generator));
         }               
     }
 
@@ -121,17 +286,19 @@ class Subnet{
     }
 
     /**
-    * Output function sends the packet number to the output port,
-    * if the division of a random number with RAND_MAX is less thab 0.95.
+    * Output function sends the packet to the output port,
+    * if it was drawn to be passed when it was received.
     * Then push the out value to message bags.
     * @return message bags
     */
     typename make_message_bags<output_ports>::type output() const {
         typename make_message_bags<output_ports>::type bags;
-         message_t out;
-        if ((double)rand() / (double) RAND_MAX  < 0.95){
-            out.value = state.packet;
-            get_messages<typename defs::out>(bags).push_back(out);
+        if (QUEUE.capacity > 0){
+            if (state.packets.front().pass){
+                get_messages<typename defs::out>(bags).push_back(state.packets.front().packet);
+            }
+        } else if (state.pass){
+            get_messages<typename defs::out>(bags).push_back(state.packet);
         }
         return bags;
     }
@@ -139,21 +306,17 @@ class Subnet{
      /**
     * time_advance function that sets the next internal transition time.
     * If the current sending state is  true then the next internal 
-    * time is set to time. Otherwise it is set
-    * to infinity.      
+    * time is set to the delay drawn for the packet. Otherwise it 
+    * is set to infinity. With a queue it is the time left to the
+    * delivery of the first packet carried.
     * @return Next internal time
     */
     TIME time_advance() const {
-        std::default_random_engine generator;
-        std::normal_distribution<double> distribution(3.0, 1.0); 
         TIME next_internal;
-        if (state.transmiting){
-            std::initializer_list<int> time = {0, 
-                                               0, 
-                                               static_cast < int > (round(distribution(generator)))
-                                               };
-            // time is hour min and second
-            next_internal = TIME(time);
+        if (QUEUE.capacity > 0 && state.transmiting){
+            next_internal = state.packets.front().delivery - state.clock;
+        } else if (state.transmiting){
+            next_internal = state.delay;
         } else{
             next_internal = std::numeric_limits<TIME>::infinity();
         }    
@@ -168,8 +331,77 @@ class Subnet{
     */
     friend std::ostringstream& operator<<(std::ostringstream& os, 
                                           const typename Subnet<TIME>::state_type& i){
-        os << "index: " << i.index << " & transmiting: " << i.transmiting; 
+        os << "index: " << i.index << " & transmiting: " << i.transmiting << 
+        " & queued: " << i.waiting; 
         return os;
     }
+
+    private:
+    /**
+    * Packets the link carries at most at once: the packets waiting in
+    * the queue, the one transmitted, and the ones propagating, whose
+    * transmissions ended at least the transmission time of a packet
+    * of packet_size bytes apart during the longest delay. Only the
+    * queue and the packet transmitted are counted when the delay or
+    * the transmission time is not bounded.
+    * @return the packets reserved, at most SUBNET_MAX_RESERVED_PACKETS
+    */
+    size_t reserved_packets() const{
+        int64_t packets = std::min<int64_t>(QUEUE.capacity, SUBNET_MAX_RESERVED_PACKETS) + 1;
+        int64_t transmission_ms = QUEUE.bandwidth > 0 ? 
+            std::llround(QUEUE.packet_size * 1000.0 / QUEUE.bandwidth) : 0;
+        double longest = state.channel.delay.max_seconds();
+        if (transmission_ms > 0 && std::isfinite(longest)){
+            packets += state.channel.delay_ms(longest) / transmission_ms + 1;
+        }
+        return size_t(std::min<int64_t>(packets, SUBNET_MAX_RESERVED_PACKETS));
+    }
+
+    /**
+    * Queues a packet received, or drops it if the queue is full,
+    * drawing whether it is passed and its delay. The transmission
+    * of a packet takes the time of its payload length, or of the
+    * packet size, at the bandwidth. The packet received, whether it
+    * is passed and the time left to its delivery are kept as without
+    * a queue.
+    * @param x packet received
+    */
+    void enqueue(const message_t &x){
+        // the packets waiting are the last ones, whose transmission starts later
+        while (state.waiting > 0 && 
+               !(state.clock < state.packets[state.packets.size() - state.waiting].start)){
+            state.waiting--;
+        }
+        state.queue_depth.record(state.waiting);
+        state.packet = x;
+        if (state.waiting >= QUEUE.capacity){
+            state.dropped++;
+            state.pass = false;
+            return;
+        }
+        link_packet carried;
+        carried.packet = x;
+        carried.pass = state.channel.loss.pass(state.generator);
+        carried.start = std::max(state.clock, state.link_free);
+        if (QUEUE.bandwidth > 0){
+            int64_t bytes = x.payload_length > 0 ? int64_t(x.payload_length) : QUEUE.packet_size;
+            state.link_free = carried.start + 
+                time_from_milliseconds<TIME>(std::llround(bytes * 1000.0 / QUEUE.bandwidth));
+        } else{
+            state.link_free = carried.start;
+        }
+        carried.delivery = state.link_free + 
+            time_from_milliseconds<TIME>(state.channel.draw_delay_ms(state.generator));
+        if (!state.packets.empty()){
+            carried.delivery = std::max(carried.delivery, state.packets.back().delivery);
+        }
+        if (state.clock < carried.start){
+            state.waiting++;
+        }
+        state.packets.push_back(carried);
+        state.transmiting = true;
+        state.pass = carried.pass;
+        state.delay = carried.delivery - state.clock;
+    }
 };    
 #endif // BOOST_SIMULATION_PDEVS_SUBNET_HPP
\ No newline at end of file
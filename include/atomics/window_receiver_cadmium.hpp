@@ -0,0 +1,205 @@
+/** \brief This header file implements the WindowReceiver class.
+*
+* The window receiver is the receiver of the window sender. Every
+* packet it receives is answered by an acknowledgement, sent after
+* its preparation time as by the receiver, but the acknowledgements
+* of packets received while one is prepared wait in turn instead of
+* replacing it.
+*
+* With Go-Back-N it only accepts the next packet in order and
+* acknowledges the last packet received in order, which acknowledges
+* every packet before it. With Selective Repeat it also keeps the
+* packets of its window received out of order, acknowledges each
+* packet of its window, and acknowledges again the packets before it
+* whose acknowledgement was lost.
+*
+* The packets received again, before the next packet in order or
+* already kept, are counted as duplicates.
+*
+*/
+
+#ifndef BOOST_SIMULATION_PDEVS_WINDOW_RECEIVER_HPP
+#define BOOST_SIMULATION_PDEVS_WINDOW_RECEIVER_HPP
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include "../data_structures/message.hpp"
+#include "../data_structures/window_mode.hpp"
+#include "receiver_cadmium.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+* The WindowReceiver class receives the packets of a window and
+* sends back their acknowledgements, on the ports of the receiver.
+*/
+template<typename TIME>
+class WindowReceiver{
+    // putting definitions in context
+    using defs = receiver_defs;
+    public:
+    //Parameters to be overwriten when instantiating the atomic model
+    TIME PREPARATION_TIME; /**< Time taken to prepare each acknowledgement */
+    int64_t WINDOW;        /**< Packets kept ahead of the next packet in order, Selective Repeat */
+    window_mode MODE;      /**< Go-Back-N or Selective Repeat */
+
+    /**
+    * Default constructor for WindowReceiver class.
+    * Preparation time of 10 seconds and a Go-Back-N window of 4 packets
+    */
+    WindowReceiver() noexcept : WindowReceiver(TIME("00:00:10"), 4, GO_BACK_N) {}
+
+    /**
+    * Constructor for WindowReceiver class.
+    * @param preparation_time time taken to send back an acknowledgement
+    * @param window window of the sender, at least 1
+    * @param mode Go-Back-N or Selective Repeat, as the sender
+    */
+    WindowReceiver(TIME preparation_time, int64_t window, window_mode mode) noexcept{
+        PREPARATION_TIME = preparation_time;
+        WINDOW = std::max<int64_t>(window, 1);
+        MODE = mode;
+        state.expected = 1;
+        state.buffered.assign(WINDOW, 0);
+        state.next_internal = std::numeric_limits<TIME>::infinity();
+        state.packets_received = 0;
+        state.duplicates = 0;
+    }
+
+    /**
+     * Structure state definition which holds the acknowledgements to send.
+     */
+    struct state_type{
+        int64_t expected;             /**< Next packet in order */
+        std::vector<int64_t> buffered; /**< Selective Repeat: packet p kept in slot (p - 1) % WINDOW, 0 if none */
+        std::vector<message_t> acks;  /**< Acknowledgements to send, the first one being prepared */
+        TIME next_internal;           /**< Time left to prepare the first acknowledgement */
+        int64_t packets_received;     /**< Packets received in order */
+        int64_t duplicates;           /**< Packets received again */
+    };  state_type state;
+
+    // ports definition
+    using input_ports = std::tuple<typename defs::in>;
+    using output_ports = std::tuple<typename defs::out>;
+
+    /**
+    * Internal transition function: the first acknowledgement was
+    * sent, the next one is prepared
+    */
+    void internal_transition(){
+        state.acks.erase(state.acks.begin());
+        state.next_internal = state.acks.empty() ? std::numeric_limits<TIME>::infinity() :
+                                                   PREPARATION_TIME;
+    }
+
+    /**
+    * External transition function: the packet received is accepted
+    * or not and its acknowledgement is queued.
+    * Only one message is expected per time unit.
+    * @param e of type time
+    * @param mbs of type message bags
+    */
+    void external_transition(TIME e,
+                             typename make_message_bags<input_ports>::type mbs){
+        if(get_messages<typename defs::in>(mbs).size()>1){
+            assert(false && "one message per time uniti");
+        }
+        if (!state.acks.empty()){
+            state.next_internal = state.next_internal - e;
+        }
+        for(const auto &x : get_messages<typename defs::in>(mbs)){
+            receive(x.packet_num);
+        }
+        if (state.next_internal == std::numeric_limits<TIME>::infinity() && !state.acks.empty()){
+            state.next_internal = PREPARATION_TIME;
+        }
+    }
+
+    /**
+    * Confluence transition function that calls internal
+    * transition fucntion followed by external transition functions.
+    * @param e of type time
+    * @param mbs of type message bags
+    */
+    void confluence_transition(TIME e,
+                               typename make_message_bags<input_ports>::type mbs){
+        internal_transition();
+        external_transition(TIME(), std::move(mbs));
+    }
+
+    /**
+    * Output function sends the first acknowledgement, the number
+    * of the packet it acknowledges.
+    * @return message bags
+    */
+    typename make_message_bags<output_ports>::type output() const {
+        typename make_message_bags<output_ports>::type bags;
+        get_messages<typename defs::out>(bags).push_back(state.acks.front());
+        return bags;
+    }
+
+    /**
+    * time_advance function return the time left to send the
+    * first acknowledgement, infinity if there is none.
+    * @return Next internal time
+    */
+    TIME time_advance() const {
+        return state.next_internal;
+    }
+
+    /**
+    * Friend is a function that outputs the next packet expected
+    * and the acknowledgements waiting to ostring stream.
+    * @param os the ostring stream
+    * @param i structure state_type
+    * @return os the ostring stream
+    */
+    friend std::ostringstream& operator<<(std::ostringstream& os,
+                                          const typename WindowReceiver<TIME>::state_type& i){
+        os << "expected: " << i.expected << " & acks: " << i.acks.size();
+        return os;
+    }
+
+    private:
+    /**
+    * Accepts a packet and queues its acknowledgement
+    * @param packet number of the packet received
+    */
+    void receive(int64_t packet){
+        if (packet < state.expected || 
+            (MODE == SELECTIVE_REPEAT && packet < state.expected + WINDOW && 
+             state.buffered[(packet - 1) % WINDOW] == packet)){
+            state.duplicates++;
+        }
+        if (MODE == GO_BACK_N){
+            if (packet == state.expected){
+                state.expected++;
+                state.packets_received++;
+            }
+            state.acks.push_back(message_t(state.expected - 1));
+            return;
+        }
+        if (packet >= state.expected + WINDOW || packet < 1){
+            return;
+        }
+        if (packet >= state.expected){
+            state.buffered[(packet - 1) % WINDOW] = packet;
+            while (state.buffered[(state.expected - 1) % WINDOW] == state.expected){
+                state.buffered[(state.expected - 1) % WINDOW] = 0;
+                state.expected++;
+                state.packets_received++;
+            }
+        }
+        state.acks.push_back(message_t(packet));
+    }
+};
+
+#endif // BOOST_SIMULATION_PDEVS_WINDOW_RECEIVER_HPP
@@ -0,0 +1,447 @@
+/** \brief This header file implements the WindowSender class.
+*
+* The window sender is the pipelined variant of the sender. It is
+* activated by a control message as the sender, but it keeps up to a
+* window of packets sent and not acknowledged yet instead of waiting
+* for the acknowledgement of each packet. It still prepares one
+* packet at a time, each one taking the preparation time, so its
+* packets leave at most one per preparation time, over the same
+* ports as the ones of the sender.
+*
+* With Go-Back-N the acknowledgements are cumulative and a single
+* timer runs from the last transmission of the oldest packet not
+* acknowledged: when it expires, every packet sent from it is sent
+* again. With Selective Repeat each packet is acknowledged on its own
+* and has its own timer, and only the packets whose timer expired are
+* sent again. The acknowledged packets are reported on the
+* acknowledgement port as they are acknowledged.
+*
+* The packets are numbered from 1 across the transfers asked by the
+* control messages, so the receiver tells the packets of a transfer
+* from the ones of the previous transfer sent again; they have no
+* alternating bit. The latency and the retransmissions of each packet
+* are measured as by the sender, and the timeout may be adaptive as
+* the one of the sender, sampled from the packets acknowledged that
+* were sent once.
+*
+*/
+
+#ifndef BOOST_SIMULATION_PDEVS_WINDOW_SENDER_HPP
+#define BOOST_SIMULATION_PDEVS_WINDOW_SENDER_HPP
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include "../data_structures/message.hpp"
+#include "../data_structures/time_conversion.hpp"
+#include "../data_structures/window_mode.hpp"
+#include "../metrics/latency_histogram.hpp"
+#include "../metrics/rtt_estimator.hpp"
+#include "../../lib/vendor/iestream.hpp"
+#include "sender_cadmium.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+* The WindowSender class sends a window of packets ahead of their
+* acknowledgements, on the ports of the sender.
+*/
+template<typename TIME>
+class WindowSender{
+    // putting definitions in context
+    using defs = sender_defs;
+    public:
+    //Parameters to be overwriten when instantiating the atomic model
+    TIME   PREPARATION_TIME; /**< Time taken to prepare each packet */
+    TIME   timeout;          /**< Time waited for the acknowledgement of a packet sent */
+    bool   adaptive_timeout; /**< The timeout is estimated from the round trip times, from timeout */
+    int64_t WINDOW;          /**< Packets sent and not acknowledged at most */
+    window_mode MODE;        /**< Go-Back-N or Selective Repeat */
+
+    /**
+    * Default constructor for WindowSender class.
+    * Preparation time of 10 seconds, timeout of 20 seconds and
+    * a Go-Back-N window of 4 packets
+    */
+    WindowSender() noexcept : WindowSender(TIME("00:00:10"), TIME("00:00:20"), 4, GO_BACK_N) {}
+
+    /**
+    * Constructor for WindowSender class.
+    * @param preparation_time time taken to prepare a packet
+    * @param timeout_time time waited for an acknowledgement
+    * @param window packets sent and not acknowledged at most, at least 1
+    * @param mode Go-Back-N or Selective Repeat
+    * @param adaptive true to estimate the timeout from the round trip times
+    */
+    WindowSender(TIME preparation_time, TIME timeout_time,
+                 int64_t window, window_mode mode, bool adaptive = false) noexcept{
+        PREPARATION_TIME = preparation_time;
+        timeout = timeout_time;
+        adaptive_timeout = adaptive;
+        state.rtt = rtt_estimator(time_to_milliseconds(timeout_time));
+        state.rto = adaptive ? time_from_milliseconds<TIME>(state.rtt.timeout_ms()) : timeout_time;
+        WINDOW = std::max<int64_t>(window, 1);
+        MODE = mode;
+        state.total_packet_num = 0;
+        state.base = 1;
+        state.next_packet = 1;
+        state.resend = 1;
+        state.window.resize(WINDOW);
+        state.packet_num = 0;
+        state.sending = false;
+        state.send_time = std::numeric_limits<TIME>::infinity();
+        state.timer = std::numeric_limits<TIME>::infinity();
+        state.model_active = false;
+        state.next_internal = std::numeric_limits<TIME>::infinity();
+        state.clock = TIME();
+        state.packets_delivered = 0;
+        state.packets_sent = 0;
+        state.retransmissions = 0;
+        state.last_delivery_time = TIME();
+    }
+
+    /**
+     * Structure of the packet held by a slot of the window
+     */
+    struct window_slot{
+        bool sent = false;           /**< The packet was sent at least once */
+        bool acked = false;          /**< The packet was acknowledged */
+        TIME first_sent;             /**< Simulation time of its first transmission */
+        TIME deadline = std::numeric_limits<TIME>::infinity(); /**< Selective Repeat: time its timer expires */
+        int64_t retransmissions = 0; /**< Times it was sent again */
+
+        /** Passes each field to an archive, which saves it or restores it
+         *  @param archive callable taking a reference to each field
+         */
+        template<typename ARCHIVE>
+        void serialize(ARCHIVE &archive){
+            archive(sent);
+            archive(acked);
+            archive(first_sent);
+            archive(deadline);
+            archive(retransmissions);
+        }
+    };
+
+    /**
+     * Structure state definition which has state variables.
+     */
+    struct state_type{
+        int64_t total_packet_num; /**< Number of the last packet of the transfers asked */
+        int64_t base;             /**< Oldest packet not acknowledged */
+        int64_t next_packet;      /**< Next packet never sent */
+        int64_t resend;           /**< Go-Back-N: next packet sent again, next_packet if none */
+        std::vector<int64_t> resend_queue; /**< Selective Repeat: packets to send again, in order */
+        std::vector<window_slot> window;   /**< Slots of the packets from base, packet p in slot (p - 1) % WINDOW */
+        int64_t packet_num;       /**< Packet being prepared */
+        bool sending;             /**< A packet is being prepared */
+        TIME send_time;           /**< Simulation time the packet prepared is sent */
+        TIME timer;               /**< Go-Back-N: simulation time the timer of base expires */
+        std::vector<message_t> acknowledged; /**< Packets acknowledged, reported at the next output */
+        bool model_active;
+        TIME next_internal;
+        TIME clock;               /**< Simulation time of the last transition */
+        int64_t packets_delivered; /**< Packets acknowledged */
+        int64_t packets_sent;      /**< Transmissions, the first ones and the retransmissions */
+        int64_t retransmissions;   /**< Packets sent again after their timeout expired */
+        TIME last_delivery_time;   /**< Simulation time of the last delivered packet */
+        latency_histogram latency; /**< Milliseconds from the first transmission to the acknowledgement */
+        latency_histogram packet_retransmission_counts; /**< Retransmissions of each delivered packet */
+        rtt_estimator rtt;         /**< Estimator of the adaptive timeout */
+        TIME rto;                  /**< Time waited for the acknowledgement of a packet sent */
+    }; state_type state;
+
+    // ports definition
+    using input_ports = std::tuple<typename defs::controlIn,
+                                   typename defs::ackIn>;
+
+    using output_ports = std::tuple<typename defs::packetSentOut,
+                                    typename defs::ackReceivedOut,
+                                    typename defs::dataOut>;
+
+    /**
+    * Internal transition function: the acknowledged packets were
+    * reported, the packet prepared is sent if it is its time and
+    * the packets whose timer expired are to be sent again. The next
+    * packet is then prepared if the window allows it.
+    */
+    void internal_transition(){
+        state.clock += state.next_internal;
+        state.acknowledged.clear();
+        if (state.sending && state.send_time == state.clock){
+            send();
+        }
+        expire_timers();
+        prepare_next();
+        schedule();
+    }
+
+    /**
+    * External transition function: a control message starts a
+    * transfer of its number of packets when the model is passive,
+    * and an acknowledgement of a packet of the window slides it.
+    * Only one message is expected per time unit and port.
+    * @param e of type time
+    * @param mbs of type message bags
+    */
+    void external_transition(TIME e,
+                             typename make_message_bags<input_ports>::type mbs){
+        state.clock += e;
+        if(get_messages<typename defs::controlIn>(mbs).size()>1 ||
+           get_messages<typename defs::ackIn>(mbs).size()>1){
+            assert(false && "one message per time uniti");
+        }
+        for(const auto &x : get_messages<typename defs::controlIn>(mbs)){
+            if (!state.model_active && x.packet_num > 0){
+                state.total_packet_num += x.packet_num;
+                state.model_active = true;
+            }
+        }
+        for(const auto &x : get_messages<typename defs::ackIn>(mbs)){
+            if (state.model_active){
+                acknowledge(x.packet_num);
+            }
+        }
+        prepare_next();
+        schedule();
+    }
+
+    /**
+    * Confluence transition function that calls internal
+    * transition fucntion followed by external transition functions.
+    * @param e of type time
+    * @param mbs of type message bags
+    */
+    void confluence_transition(TIME e,
+                               typename make_message_bags<input_ports>::type mbs){
+        internal_transition();
+        external_transition(TIME(), std::move(mbs));
+    }
+
+    /**
+    * Output function reports the packets acknowledged and sends the
+    * packet prepared if it is its time, with its number.
+    * @return Message bags
+    */
+    typename make_message_bags<output_ports>::type output() const {
+        typename make_message_bags<output_ports>::type bags;
+        for (const message_t &acked : state.acknowledged){
+            get_messages<typename defs::ackReceivedOut>(bags).push_back(acked);
+        }
+        if (state.sending && state.send_time == state.clock + state.next_internal){
+            get_messages<typename defs::dataOut>(bags).push_back(message_t(state.packet_num));
+            get_messages<typename defs::packetSentOut>(bags).push_back(message_t(state.packet_num));
+        }
+        return bags;
+    }
+
+    /**
+    * time_advance function return the next internal transition time.
+    * @return Next internal time
+    */
+    TIME time_advance() const {
+        return state.next_internal;
+    }
+
+    /**
+    * Friend is a function that outputs the window, the total
+    * packet number and the timeout to ostring stream.
+    * @param os the ostring stream
+    * @param i structure state_type
+    * @return os the ostring stream
+    */
+    friend std::ostringstream& operator<<(std::ostringstream& os,
+                                          const typename WindowSender<TIME>::state_type& i){
+        os << "base: " << i.base << " & next_packet: " << i.next_packet <<
+        " & total_packet_num: " << i.total_packet_num << " & rto: " << i.rto;
+        return os;
+    }
+
+    private:
+    /**
+    * @param packet packet of the window
+    * @return the slot of the packet
+    */
+    window_slot &slot(int64_t packet){
+        return state.window[(packet - 1) % WINDOW];
+    }
+
+    /**
+    * Sends the packet prepared, starting its timer. With Go-Back-N
+    * the timer runs from the last transmission of the oldest packet.
+    * A packet acknowledged while it was prepared is sent all the same,
+    * and counted as sent.
+    */
+    void send(){
+        state.sending = false;
+        state.packets_sent ++;
+        int64_t packet = state.packet_num;
+        if (packet < state.base || slot(packet).acked){
+            return;
+        }
+        window_slot &sent = slot(packet);
+        if (!sent.sent){
+            sent.sent = true;
+            sent.first_sent = state.clock;
+        }
+        if (MODE == SELECTIVE_REPEAT){
+            sent.deadline = state.clock + state.rto;
+        } else if (state.timer == std::numeric_limits<TIME>::infinity() || packet == state.base){
+            state.timer = state.clock + state.rto;
+        }
+    }
+
+    /**
+    * Queues the packets whose timer expired to be sent again. An
+    * adaptive timeout is doubled once when timers expire.
+    */
+    void expire_timers(){
+        bool expired_any = false;
+        if (MODE == GO_BACK_N){
+            if (state.timer == state.clock){
+                state.timer = std::numeric_limits<TIME>::infinity();
+                state.resend = state.base;
+                expired_any = true;
+            }
+        } else{
+            for (int64_t packet = state.base; packet < state.next_packet; packet++){
+                window_slot &expired = slot(packet);
+                if (!expired.acked && expired.deadline == state.clock){
+                    expired.deadline = std::numeric_limits<TIME>::infinity();
+                    state.resend_queue.push_back(packet);
+                    expired_any = true;
+                }
+            }
+        }
+        if (expired_any && adaptive_timeout){
+            state.rtt.back_off();
+            state.rto = time_from_milliseconds<TIME>(state.rtt.timeout_ms());
+        }
+    }
+
+    /**
+    * Samples the round trip time of the packet acknowledged for the
+    * adaptive timeout, if it was sent once
+    * @param packet packet acknowledged by the receiver
+    */
+    void sample_round_trip(int64_t packet){
+        const window_slot &acked = slot(packet);
+        if (adaptive_timeout && acked.sent && !acked.acked && acked.retransmissions == 0){
+            state.rtt.sample(time_to_milliseconds(state.clock - acked.first_sent));
+            state.rto = time_from_milliseconds<TIME>(state.rtt.timeout_ms());
+        }
+    }
+
+    /**
+    * Acknowledges a packet, every packet up to it with Go-Back-N,
+    * and slides the window past the packets acknowledged
+    * @param packet packet acknowledged by the receiver
+    */
+    void acknowledge(int64_t packet){
+        if (packet < state.base || packet >= state.next_packet){
+            return;
+        }
+        sample_round_trip(packet);
+        if (MODE == GO_BACK_N){
+            for (int64_t p = state.base; p <= packet; p++){
+                deliver(p);
+            }
+            state.base = packet + 1;
+            state.resend = std::max(state.resend, state.base);
+            state.timer = state.base < state.next_packet && slot(state.base).sent ?
+                          state.clock + state.rto : std::numeric_limits<TIME>::infinity();
+        } else{
+            if (slot(packet).acked || !slot(packet).sent){
+                return;
+            }
+            deliver(packet);
+            while (state.base < state.next_packet && slot(state.base).acked){
+                state.base++;
+            }
+        }
+    }
+
+    /**
+    * Counts a packet as delivered and records its latency and retransmissions
+    */
+    void deliver(int64_t packet){
+        window_slot &delivered = slot(packet);
+        delivered.acked = true;
+        delivered.deadline = std::numeric_limits<TIME>::infinity();
+        state.packets_delivered ++;
+        state.last_delivery_time = state.clock;
+        state.latency.record(time_to_milliseconds(state.clock - delivered.first_sent));
+        state.packet_retransmission_counts.record(delivered.retransmissions);
+        state.acknowledged.push_back(message_t(packet));
+    }
+
+    /**
+    * Prepares the next packet when none is: a packet to send again
+    * first, else the next packet of the transfers if the window
+    * allows it. The model is passive once every packet is acknowledged.
+    */
+    void prepare_next(){
+        if (state.sending){
+            return;
+        }
+        int64_t packet = 0;
+        if (MODE == GO_BACK_N && state.resend < state.next_packet){
+            packet = state.resend++;
+        }
+        while (MODE == SELECTIVE_REPEAT && packet == 0 && !state.resend_queue.empty()){
+            int64_t queued = state.resend_queue.front();
+            state.resend_queue.erase(state.resend_queue.begin());
+            if (queued >= state.base && !slot(queued).acked){
+                packet = queued;
+            }
+        }
+        if (packet != 0){
+            state.retransmissions ++;
+            slot(packet).retransmissions ++;
+        } else if (state.next_packet <= state.total_packet_num &&
+                   state.next_packet < state.base + WINDOW){
+            packet = state.next_packet++;
+            slot(packet) = window_slot();
+            state.resend = state.next_packet;
+        }
+        if (packet != 0){
+            state.packet_num = packet;
+            state.sending = true;
+            state.send_time = state.clock + PREPARATION_TIME;
+        }
+        state.model_active = state.sending || state.base <= state.total_packet_num;
+    }
+
+    /**
+    * Sets the time advance to the next of the report of the packets
+    * acknowledged, the transmission of the packet prepared and the
+    * expiry of the timers
+    */
+    void schedule(){
+        TIME next = std::numeric_limits<TIME>::infinity();
+        if (!state.acknowledged.empty()){
+            next = state.clock;
+        }
+        if (state.sending){
+            next = std::min(next, state.send_time);
+        }
+        if (MODE == GO_BACK_N){
+            next = std::min(next, state.timer);
+        } else{
+            for (int64_t packet = state.base; packet < state.next_packet; packet++){
+                next = std::min(next, slot(packet).deadline);
+            }
+        }
+        state.next_internal = next == std::numeric_limits<TIME>::infinity() ?
+                              next : next - state.clock;
+    }
+};
+
+#endif // BOOST_SIMULATION_PDEVS_WINDOW_SENDER_HPP
@@ -0,0 +1,252 @@
+/** \brief This header file implements the archives that save and restore the state of a run.
+ *
+ * A checkpoint is written and read by the same code: the state of
+ * each model passes each of its fields to an archive, the writer
+ * writing it and the reader setting it from the file. Numbers are
+ * written as their bytes, little endian whatever the byte order of
+ * the host, floating point numbers as the bytes of their bits, times
+ * as milliseconds,
+ * vectors as their size followed by their elements, and classes
+ * that have a serialize(archive) function pass their fields
+ * themselves. Standard distributions, whose cached values are only
+ * reachable through their stream operators, are written as text.
+ */
+
+#ifndef __CHECKPOINT_ARCHIVE_HPP__
+#define __CHECKPOINT_ARCHIVE_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../data_structures/byte_order.hpp"
+#include "../data_structures/time_conversion.hpp"
+#include "../metrics/latency_histogram.hpp"
+
+/**
+ * Milliseconds written for an infinite time
+ */
+#define CHECKPOINT_INFINITY INT64_MAX
+
+/**
+ * Largest number of elements of a vector read, so a damaged size
+ * fails the reader instead of allocating all the memory
+ */
+#define CHECKPOINT_MAX_ELEMENTS (uint64_t(1) << 32)
+
+/**
+ * Unsigned integer of the size of a number, which holds its bits
+ */
+template<typename T>
+using checkpoint_bits = typename std::conditional<sizeof(T) == 8, uint64_t,
+                        typename std::conditional<sizeof(T) == 4, uint32_t,
+                        typename std::conditional<sizeof(T) == 2, uint16_t, uint8_t>::type>::type>::type;
+
+/**
+ * Archive writing the fields passed to it to a stream
+ */
+template<typename TIME>
+class checkpoint_writer{
+    public:
+    static constexpr bool restoring = false; ///< The fields are not changed
+
+    /**
+     * @param os stream the fields are written to, opened in binary
+     */
+    explicit checkpoint_writer(std::ostream &os) : os(os) {}
+
+    /**
+     * Writes a number, or the fields of a class through its serialize function
+     */
+    template<typename T>
+    void operator()(T &value){
+        if constexpr (std::is_same<T, bool>::value){
+            put(uint8_t(value ? 1 : 0));
+        } else if constexpr (std::is_arithmetic<T>::value){
+            put(value);
+        } else{
+            value.serialize(*this);
+        }
+    }
+
+    /**
+     * Writes the size of a vector and its elements
+     */
+    template<typename T>
+    void operator()(std::vector<T> &values){
+        put(uint64_t(values.size()));
+        for (T &value : values){
+            (*this)(value);
+        }
+    }
+
+    /**
+     * Writes a time in milliseconds
+     */
+    void operator()(TIME &time){
+        put(time == std::numeric_limits<TIME>::infinity() ? int64_t(CHECKPOINT_INFINITY)
+                                                          : time_to_milliseconds(time));
+    }
+
+    /**
+     * Writes a text as its size and its characters
+     */
+    void operator()(std::string &text){
+        put(uint64_t(text.size()));
+        os.write(text.data(), text.size());
+    }
+
+    /**
+     * Writes a normal distribution, with the value it keeps for its next draw
+     */
+    void operator()(std::normal_distribution<double> &distribution){
+        std::ostringstream text;
+        text << distribution;
+        std::string written = text.str();
+        (*this)(written);
+    }
+
+    /**
+     * Marks the archive as failed, the writer never fails on its fields
+     */
+    void fail(){
+        os.setstate(std::ios::failbit);
+    }
+
+    /**
+     * @return false if a field could not be written
+     */
+    bool good() const{
+        return static_cast<bool>(os);
+    }
+
+    private:
+    std::ostream &os;
+
+    template<typename T>
+    void put(const T &value){
+        static_assert(sizeof(T) <= 8 && sizeof(checkpoint_bits<T>) == sizeof(T),
+                      "numbers are written as 1, 2, 4 or 8 bytes");
+        checkpoint_bits<T> bits;
+        memcpy(&bits, &value, sizeof(bits));
+        char bytes[sizeof(T)];
+        store_little_endian(bits, bytes, sizeof(bytes));
+        os.write(bytes, sizeof(bytes));
+    }
+};
+
+/**
+ * Archive setting the fields passed to it from a stream
+ */
+template<typename TIME>
+class checkpoint_reader{
+    public:
+    static constexpr bool restoring = true; ///< The fields are set from the stream
+
+    /**
+     * @param is stream the fields are read from, opened in binary
+     */
+    explicit checkpoint_reader(std::istream &is) : is(is) {}
+
+    /**
+     * Reads a number, or the fields of a class through its serialize function
+     */
+    template<typename T>
+    void operator()(T &value){
+        if constexpr (std::is_same<T, bool>::value){
+            uint8_t byte = 0;
+            get(byte);
+            value = byte != 0;
+        } else if constexpr (std::is_arithmetic<T>::value){
+            get(value);
+        } else{
+            value.serialize(*this);
+        }
+    }
+
+    /**
+     * Reads the size of a vector and its elements
+     */
+    template<typename T>
+    void operator()(std::vector<T> &values){
+        uint64_t size = 0;
+        get(size);
+        if (size > CHECKPOINT_MAX_ELEMENTS){
+            fail();
+        }
+        values.resize(good() ? size : 0);
+        for (T &value : values){
+            (*this)(value);
+        }
+    }
+
+    /**
+     * Reads a time in milliseconds
+     */
+    void operator()(TIME &time){
+        int64_t ms = 0;
+        get(ms);
+        time = ms == CHECKPOINT_INFINITY ? std::numeric_limits<TIME>::infinity()
+                                         : time_from_milliseconds<TIME>(ms);
+    }
+
+    /**
+     * Reads a text as its size and its characters
+     */
+    void operator()(std::string &text){
+        uint64_t size = 0;
+        get(size);
+        if (size > CHECKPOINT_MAX_ELEMENTS){
+            fail();
+        }
+        text.resize(good() ? size : 0);
+        is.read(&text[0], text.size());
+    }
+
+    /**
+     * Reads a normal distribution, with the value it keeps for its next draw
+     */
+    void operator()(std::normal_distribution<double> &distribution){
+        std::string written;
+        (*this)(written);
+        std::istringstream text(written);
+        if (!(text >> distribution)){
+            fail();
+        }
+    }
+
+    /**
+     * Marks the archive as failed, when a field read is not valid
+     */
+    void fail(){
+        is.setstate(std::ios::failbit);
+    }
+
+    /**
+     * @return false if a field could not be read or was not valid
+     */
+    bool good() const{
+        return static_cast<bool>(is);
+    }
+
+    private:
+    std::istream &is;
+
+    template<typename T>
+    void get(T &value){
+        static_assert(sizeof(T) <= 8 && sizeof(checkpoint_bits<T>) == sizeof(T),
+                      "numbers are read as 1, 2, 4 or 8 bytes");
+        char bytes[sizeof(T)] = {};
+        is.read(bytes, sizeof(bytes));
+        checkpoint_bits<T> bits = static_cast<checkpoint_bits<T>>(load_little_endian(bytes, sizeof(bytes)));
+        memcpy(&value, &bits, sizeof(bits));
+    }
+};
+
+#endif // __CHECKPOINT_ARCHIVE_HPP__
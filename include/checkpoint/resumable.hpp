@@ -0,0 +1,97 @@
+/** \brief This header file implements the wrapper of the atomic models that can be checkpointed.
+ *
+ * The runner keeps the time of the last transition of each atomic
+ * model, which is needed to save a run between two events and to
+ * resume it, but does not give it out, and a runner created at a
+ * later time starts every model with no time elapsed. resumable<ATOMIC>::model
+ * wraps an atomic model class as profiled<ATOMIC>::model does: it
+ * keeps the time of the last transition of the model, and once
+ * resumed at a later time it shortens its first time advance and
+ * lengthens the elapsed time of its first external transition by the
+ * time that had elapsed when the run was saved. Its state is still
+ * reached by casting to the atomic model class.
+ *
+ * Models are only wrapped when the run is checkpointed or restored.
+ */
+
+#ifndef __RESUMABLE_HPP__
+#define __RESUMABLE_HPP__
+
+#include <limits>
+#include <utility>
+
+#include <cadmium/modeling/message_bag.hpp>
+
+/**
+ * Wrapper of the atomic model class ATOMIC. resumable<ATOMIC>::model
+ * is an atomic model class that can be given to cadmium.
+ */
+template<template<typename TIME> class ATOMIC>
+struct resumable{
+    template<typename TIME>
+    class model : public ATOMIC<TIME>{
+        using base = ATOMIC<TIME>;
+        using input_bags = typename cadmium::make_message_bags<typename base::input_ports>::type;
+
+        public:
+        /**
+         * Builds the atomic model, with no time elapsed at time zero
+         * @param args arguments of the constructor of the atomic model
+         */
+        template<typename... Args>
+        explicit model(Args&&... args) :
+            base(std::forward<Args>(args)...), reference(), elapsed() {}
+
+        void internal_transition(){
+            reference = reference + time_advance();
+            elapsed = TIME();
+            base::internal_transition();
+        }
+
+        void external_transition(TIME e, input_bags mbs){
+            reference = reference + e;
+            TIME base_e = e + elapsed;
+            elapsed = TIME();
+            base::external_transition(base_e, std::move(mbs));
+        }
+
+        void confluence_transition(TIME e, input_bags mbs){
+            reference = reference + e;
+            TIME base_e = e + elapsed;
+            elapsed = TIME();
+            base::confluence_transition(base_e, std::move(mbs));
+        }
+
+        TIME time_advance() const{
+            TIME advance = base::time_advance();
+            if (advance == std::numeric_limits<TIME>::infinity()){
+                return advance;
+            }
+            return advance - elapsed;
+        }
+
+        /**
+         * @return time of the last transition of the model
+         */
+        TIME last_transition() const{
+            return reference - elapsed;
+        }
+
+        /**
+         * Resumes the model, its state restored, in a runner created
+         * at a later time than its last transition
+         * @param last time of the last transition of the model
+         * @param time time the runner is created at
+         */
+        void resume(const TIME &last, const TIME &time){
+            reference = time;
+            elapsed = time - last;
+        }
+
+        private:
+        TIME reference; ///< Time of the last transition as seen by the runner
+        TIME elapsed;   ///< Time elapsed since the last transition of the model at the reference
+    };
+};
+
+#endif // __RESUMABLE_HPP__
@@ -0,0 +1,41 @@
+/** \brief Header file for the byte order of the binary files
+ *
+ * The binary files of the simulator, the binary event inputs, the
+ * binary traces and the checkpoints, store their integers little
+ * endian whatever the byte order of the host, so a file written on
+ * one host is read on any other. The integers are stored and loaded
+ * a byte at a time, which compilers turn into a single move on a
+ * little endian host.
+ */
+
+#ifndef BOOST_SIMULATION_BYTE_ORDER_HPP
+#define BOOST_SIMULATION_BYTE_ORDER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Stores the low bytes of an integer, little endian
+ *  @param value integer stored
+ *  @param bytes bytes it is stored to
+ *  @param size number of bytes stored, at most 8
+ */
+inline void store_little_endian(uint64_t value, char *bytes, size_t size){
+    for (size_t i = 0; i < size; i++){
+        bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+/** Loads an integer stored little endian
+ *  @param bytes bytes it is loaded from
+ *  @param size number of bytes loaded, at most 8
+ *  @return the integer, its high bytes zero
+ */
+inline uint64_t load_little_endian(const char *bytes, size_t size){
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++){
+        value |= uint64_t(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+
+#endif ///< BOOST_SIMULATION_BYTE_ORDER_HPP - end of ifndef
@@ -1,4 +1,3 @@
-
 /** \brief Header file for message containing headers
  * 
  * Defines a message_t structure
@@ -8,30 +7,71 @@
 #define BOOST_SIMULATION_MESSAGE_HPP
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <iostream>
 #include <string>
 
 using namespace std;
 
 /** Define structure of message_t
- *  message_t will containg a a field value of type float
+ *  message_t holds a packet number, or the number of packets of
+ *  a control message, its alternating bit if it has one and the
+ *  length of its payload. It is written and read as
+ *  packet_num[:alt_bit[:payload_length]], e.g. 5 or 12:0
  */
 struct message_t{
 
-    message_t(){}
-    message_t(float i_value)
-    :value(i_value){}
+    static const int8_t NO_BIT = -1; ///< Alternating bit of messages without one
+
+    message_t()
+    :packet_num(0), payload_length(0), alt_bit(NO_BIT){}
+    message_t(int64_t i_packet_num, int8_t i_alt_bit = NO_BIT, 
+              uint32_t i_payload_length = 0)
+    :packet_num(i_packet_num), payload_length(i_payload_length), alt_bit(i_alt_bit){}
 
-  	float   value;
+    int64_t  packet_num;     ///< Sequence number of the packet
+    uint32_t payload_length; ///< Length of the payload, 0 if not used
+    int8_t   alt_bit;        ///< Alternating bit, 0, 1 or NO_BIT
 
     void clear(){
-        message_t(); 
+        *this = message_t(); 
+    }
+
+    /** Passes each field to an archive, which saves it or restores it
+     *  @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        archive(packet_num);
+        archive(payload_length);
+        archive(alt_bit);
     }
 };
 
 istream& operator>> (istream& is, message_t& msg);
 
+/** Reads a message from the characters [begin, end) of a word
+ *  without copying them, as the input parser reads its files
+ *  @return false if the word is not a message
+ */
+bool parse_input(const char *begin, const char *end, message_t& msg);
+
+/** Size of a message in a binary event file: the packet number,
+ *  the payload length, the alternating bit and 3 bytes of padding
+ */
+#define MESSAGE_RECORD_SIZE 16
+
+/** Reads a message from its bytes in a binary event file
+ *  @return false if there are not enough bytes or they are not valid
+ */
+bool decode_input(const char *bytes, size_t size, message_t& msg);
+
+/** Writes the MESSAGE_RECORD_SIZE bytes of a message in a binary event file
+ */
+void encode_input(const message_t& msg, char *bytes);
+
 ostream& operator<<(ostream& os, const message_t& msg);
 
 
-#endif ///< BOOST_SIMULATION_MESSAGE_HPP - end of ifndef
\ No newline at end of file
+#endif ///< BOOST_SIMULATION_MESSAGE_HPP - end of ifndef
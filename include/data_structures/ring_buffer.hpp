@@ -0,0 +1,125 @@
+/** \brief Header file for the ring buffer of the subnets
+ *
+ * Defines a FIFO ring buffer over a vector whose size is a power of
+ * two. Elements are pushed at the back and popped at the front
+ * without any allocation; the vector only doubles when it is full,
+ * so it grows to the largest number of elements held at once and
+ * then never allocates again.
+ */
+
+#ifndef BOOST_SIMULATION_RING_BUFFER_HPP
+#define BOOST_SIMULATION_RING_BUFFER_HPP
+
+#include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+/** FIFO of elements held in a ring
+ */
+template<typename T>
+class ring_buffer{
+    public:
+    ring_buffer() : head(0), count(0) {}
+
+    /** Allocates room for at least a number of elements
+     *  @param capacity number of elements held without growing
+     */
+    void reserve(size_t capacity){
+        size_t size = std::max<size_t>(items.size(), 1);
+        while (size < capacity){
+            size *= 2;
+        }
+        if (size != items.size()){
+            resize(size);
+        }
+    }
+
+    bool empty() const{
+        return count == 0;
+    }
+
+    size_t size() const{
+        return count;
+    }
+
+    /** @return the i-th element from the front
+     */
+    T &operator[](size_t i){
+        return items[(head + i) & (items.size() - 1)];
+    }
+
+    const T &operator[](size_t i) const{
+        return items[(head + i) & (items.size() - 1)];
+    }
+
+    T &front(){
+        return (*this)[0];
+    }
+
+    const T &front() const{
+        return (*this)[0];
+    }
+
+    T &back(){
+        return (*this)[count - 1];
+    }
+
+    const T &back() const{
+        return (*this)[count - 1];
+    }
+
+    /** Adds an element at the back, doubling the ring if it is full
+     */
+    void push_back(const T &value){
+        if (count == items.size()){
+            reserve(2 * count);
+        }
+        (*this)[count] = value;
+        count++;
+    }
+
+    /** Removes the element at the front
+     */
+    void pop_front(){
+        assert(count > 0 && "pop of an empty ring buffer");
+        head = (head + 1) & (items.size() - 1);
+        count--;
+    }
+
+    /** Passes the elements, from the front, to an archive, which saves
+     *  them or restores them
+     *  @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        std::vector<T> in_order;
+        for (size_t i = 0; i < count; i++){
+            in_order.push_back((*this)[i]);
+        }
+        archive(in_order);
+        if (ARCHIVE::restoring){
+            head = count = 0;
+            reserve(in_order.size());
+            for (const T &value : in_order){
+                push_back(value);
+            }
+        }
+    }
+
+    private:
+    std::vector<T> items; ///< Ring, its size is 0 or a power of two
+    size_t head;          ///< Index of the front element
+    size_t count;         ///< Number of elements held
+
+    void resize(size_t size){
+        std::vector<T> larger(size);
+        for (size_t i = 0; i < count; i++){
+            larger[i] = (*this)[i];
+        }
+        items.swap(larger);
+        head = 0;
+    }
+};
+
+#endif ///< BOOST_SIMULATION_RING_BUFFER_HPP - end of ifndef
@@ -0,0 +1,175 @@
+/** \brief Header file for the integer tick time
+ *
+ * Defines TickTime, a time made of a signed 64 bit count of
+ * milliseconds. It can replace NDTime as the TIME of the models:
+ * it has an infinity, the arithmetic and comparisons used by
+ * cadmium, and it reads and writes the HH:MM:SS:mmm format of
+ * the input and output files. Arithmetic and comparisons are
+ * single integer operations, infinity being the largest count.
+ */
+
+#ifndef __TICK_TIME_HPP__
+#define __TICK_TIME_HPP__
+
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/** Define class TickTime
+ *  TickTime holds a count of milliseconds
+ */
+class TickTime{
+    public:
+    static constexpr int64_t TICKS_PER_SECOND = 1000; ///< Resolution of the time
+    static constexpr int64_t INF = std::numeric_limits<int64_t>::max(); ///< Count of infinity
+
+    /**
+     * Zero time
+     */
+    constexpr TickTime() : ticks(0) {}
+
+    /**
+     * Time from its fields as NDTime: hours, minutes, seconds
+     * and milliseconds, missing trailing fields being zero
+     * @param fields fields of the time
+     */
+    TickTime(std::initializer_list<int> fields){
+        const int *field = fields.begin();
+        size_t n = fields.size();
+        ticks = (((n > 0 ? field[0] : 0) * int64_t(60) + 
+                  (n > 1 ? field[1] : 0)) * 60 + 
+                  (n > 2 ? field[2] : 0)) * 1000 + 
+                  (n > 3 ? field[3] : 0);
+    }
+
+    /**
+     * Time from its HH:MM:SS:mmm representation or inf, as NDTime
+     * rejects a text that is not a time
+     * @param text the time, fields may be omitted from the right
+     * @throws std::invalid_argument if the text is not a time
+     */
+    TickTime(const char *text);
+    TickTime(const std::string &text) : TickTime(text.c_str()) {}
+
+    /**
+     * Time from a count of milliseconds
+     * @param count milliseconds
+     * @return the time
+     */
+    static constexpr TickTime from_ticks(int64_t count){
+        return TickTime(count, 0);
+    }
+
+    /**
+     * @return count of milliseconds, INF for infinity
+     */
+    constexpr int64_t count() const{
+        return ticks;
+    }
+
+    /**
+     * Sum, infinity plus any time is infinity and minus infinity
+     * plus a finite time is minus infinity
+     */
+    TickTime& operator+=(const TickTime &other){
+        if (ticks == INF || other.ticks == INF){
+            ticks = INF;
+        } else if (ticks == -INF || other.ticks == -INF){
+            ticks = -INF;
+        } else{
+            ticks += other.ticks;
+        }
+        return *this;
+    }
+
+    /**
+     * Difference, an infinity minus any time is that infinity and
+     * a finite time minus an infinity is the opposite infinity
+     */
+    TickTime& operator-=(const TickTime &other){
+        if (ticks != INF && ticks != -INF){
+            if (other.ticks == INF || other.ticks == -INF){
+                ticks = -other.ticks;
+            } else{
+                ticks -= other.ticks;
+            }
+        }
+        return *this;
+    }
+
+    friend TickTime operator+(TickTime a, const TickTime &b){
+        return a += b;
+    }
+
+    friend TickTime operator-(TickTime a, const TickTime &b){
+        return a -= b;
+    }
+
+    friend constexpr bool operator==(const TickTime &a, const TickTime &b){
+        return a.ticks == b.ticks;
+    }
+
+    friend constexpr bool operator!=(const TickTime &a, const TickTime &b){
+        return a.ticks != b.ticks;
+    }
+
+    friend constexpr bool operator<(const TickTime &a, const TickTime &b){
+        return a.ticks < b.ticks;
+    }
+
+    friend constexpr bool operator>(const TickTime &a, const TickTime &b){
+        return a.ticks > b.ticks;
+    }
+
+    friend constexpr bool operator<=(const TickTime &a, const TickTime &b){
+        return a.ticks <= b.ticks;
+    }
+
+    friend constexpr bool operator>=(const TickTime &a, const TickTime &b){
+        return a.ticks >= b.ticks;
+    }
+
+    private:
+    int64_t ticks; ///< Count of milliseconds
+
+    constexpr TickTime(int64_t count, int) : ticks(count) {}
+};
+
+/**
+ * Reads a time as HH:MM:SS:mmm or inf. The time is not changed
+ * and the stream fails if it is not valid.
+ */
+std::istream& operator>>(std::istream &is, TickTime &time);
+
+/**
+ * Writes a time as HH:MM:SS:mmm, as NDTime does, or inf
+ */
+std::ostream& operator<<(std::ostream &os, const TickTime &time);
+
+namespace std{
+    /**
+     * Infinity of TickTime used by cadmium for passive models
+     */
+    template<>
+    class numeric_limits<TickTime>{
+        public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool has_infinity = true;
+        static constexpr TickTime infinity() noexcept{
+            return TickTime::from_ticks(TickTime::INF);
+        }
+        static constexpr TickTime max() noexcept{
+            return TickTime::from_ticks(TickTime::INF);
+        }
+        static constexpr TickTime min() noexcept{
+            return TickTime::from_ticks(0);
+        }
+        static constexpr TickTime lowest() noexcept{
+            return TickTime::from_ticks(-TickTime::INF);
+        }
+    };
+}
+
+#endif // __TICK_TIME_HPP__
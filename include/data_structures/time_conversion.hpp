@@ -0,0 +1,89 @@
+/** \brief Header file for the conversions of the simulation time
+ *
+ * Converts a simulation time from and to a count of milliseconds,
+ * which the models use for their metrics, their drawn delays and
+ * their adaptive timeouts, and the binary files for their times.
+ * The models convert their clock on every packet, so NDTime is
+ * converted from and to its fields, TickTime is its own count of
+ * milliseconds, and only other time types are printed and read
+ * back from their HH:MM:SS:mmm representation.
+ */
+
+#ifndef __TIME_CONVERSION_HPP__
+#define __TIME_CONVERSION_HPP__
+
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+#include "tick_time.hpp"
+
+/**
+ * True for the time types that give their hours, minutes, seconds
+ * and milliseconds, as NDTime
+ */
+template<typename TIME, typename = void>
+struct has_time_fields : std::false_type {};
+
+template<typename TIME>
+struct has_time_fields<TIME, std::void_t<decltype(std::declval<const TIME &>().getHours()),
+                                         decltype(std::declval<const TIME &>().getMinutes()),
+                                         decltype(std::declval<const TIME &>().getSeconds()),
+                                         decltype(std::declval<const TIME &>().getMilliseconds())>>
+    : std::true_type {};
+
+/**
+ * Converts a simulation time to milliseconds
+ * @param time simulation time
+ * @return milliseconds
+ */
+template<typename TIME>
+int64_t time_to_milliseconds(const TIME &time){
+    if constexpr (has_time_fields<TIME>::value){
+        return ((int64_t(time.getHours()) * 60 + time.getMinutes()) * 60
+                + time.getSeconds()) * 1000 + time.getMilliseconds();
+    }
+    std::ostringstream os;
+    os << time;
+    std::istringstream is(os.str());
+    int64_t ms = 0;
+    int64_t field;
+    char separator;
+    for (int64_t unit : {3600000, 60000, 1000, 1}){
+        if (is >> field){
+            ms += field * unit;
+        }
+        is >> separator;
+    }
+    return ms;
+}
+
+/**
+ * Count of milliseconds of a TickTime
+ */
+inline int64_t time_to_milliseconds(const TickTime &time){
+    return time.count();
+}
+
+/**
+ * Builds a simulation time from a count of milliseconds, from its
+ * fields as NDTime does
+ * @param ms milliseconds
+ * @return simulation time
+ */
+template<typename TIME>
+TIME time_from_milliseconds(int64_t ms){
+    return TIME({static_cast<int>(ms / 3600000), static_cast<int>(ms / 60000 % 60),
+                 static_cast<int>(ms / 1000 % 60), static_cast<int>(ms % 1000)});
+}
+
+/**
+ * TickTime of a count of milliseconds
+ */
+template<>
+inline TickTime time_from_milliseconds<TickTime>(int64_t ms){
+    return TickTime::from_ticks(ms);
+}
+
+#endif // __TIME_CONVERSION_HPP__
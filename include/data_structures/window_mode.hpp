@@ -0,0 +1,28 @@
+/** \brief Header file for the modes of the windowed sender and receiver
+ *
+ * Defines the window_mode enumeration shared by both models
+ */
+
+#ifndef BOOST_SIMULATION_WINDOW_MODE_HPP
+#define BOOST_SIMULATION_WINDOW_MODE_HPP
+
+/** Protocols of the windowed sender and receiver
+ *  GO_BACK_N         the receiver acknowledges the last packet received
+ *                    in order and the sender sends again every packet
+ *                    from the oldest one not acknowledged after a timeout
+ *  SELECTIVE_REPEAT  the receiver keeps the packets of its window and
+ *                    acknowledges each of them, the sender only sends
+ *                    again the packets whose timeout expired
+ */
+enum window_mode{
+    GO_BACK_N,
+    SELECTIVE_REPEAT
+};
+
+/** @return the name of a mode as it is printed
+ */
+inline const char *window_mode_name(window_mode mode){
+    return mode == SELECTIVE_REPEAT ? "selective repeat" : "go-back-n";
+}
+
+#endif ///< BOOST_SIMULATION_WINDOW_MODE_HPP - end of ifndef
@@ -0,0 +1,183 @@
+/** \brief This header file implements the latency histogram of the atomic models.
+ *
+ * Histogram of non negative integer values, such as latencies in
+ * milliseconds or counts, in the manner of HdrHistogram: values are
+ * grouped in buckets whose width doubles with each power of two, and
+ * each power of two is split in the same number of sub-buckets. Its
+ * memory does not depend on the number of values recorded and any
+ * percentile is reported within 1/64 of its value. The buckets are
+ * only allocated up to the one of the largest value recorded, so an
+ * empty histogram, as the one of each of many flows, is small.
+ */
+
+#ifndef __LATENCY_HISTOGRAM_HPP__
+#define __LATENCY_HISTOGRAM_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/**
+ * Histogram of non negative values with a relative precision of 1/64
+ */
+class latency_histogram{
+    public:
+    static constexpr int SUB_BUCKET_BITS = 7;                  ///< Values below 2^7 have their own bucket
+    static constexpr int64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS + SUB_BUCKETS;
+
+    latency_histogram() : total(0), sum(0),
+                          minimum(std::numeric_limits<int64_t>::max()), maximum(0) {}
+
+    /**
+     * Records a value, negative values are recorded as 0
+     * @param value value recorded
+     */
+    void record(int64_t value){
+        if (value < 0){
+            value = 0;
+        }
+        size_t index = index_of(value);
+        if (index >= counts.size()){
+            counts.resize(index + 1, 0);
+        }
+        counts[index]++;
+        total++;
+        sum += value;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+
+    /**
+     * Adds the values recorded by another histogram
+     * @param other histogram added
+     */
+    void merge(const latency_histogram &other){
+        if (other.counts.size() > counts.size()){
+            counts.resize(other.counts.size(), 0);
+        }
+        for (size_t i = 0; i < other.counts.size(); i++){
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+    }
+
+    /**
+     * @return number of values recorded
+     */
+    uint64_t count() const{
+        return total;
+    }
+
+    /**
+     * @return smallest value recorded, 0 if there is none
+     */
+    int64_t min() const{
+        return total ? minimum : 0;
+    }
+
+    /**
+     * @return largest value recorded, 0 if there is none
+     */
+    int64_t max() const{
+        return maximum;
+    }
+
+    /**
+     * @return mean of the values recorded, 0 if there is none
+     */
+    double mean() const{
+        return total ? sum / total : 0;
+    }
+
+    /**
+     * Value below which the given percentage of the values falls,
+     * the highest value of its bucket and never more than max()
+     * @param percentile percentage between 0 and 100
+     * @return the value, 0 if no value was recorded
+     */
+    int64_t percentile(double percentile) const{
+        if (total == 0){
+            return 0;
+        }
+        uint64_t rank = uint64_t(percentile / 100 * total + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++){
+            seen += counts[i];
+            if (seen >= rank){
+                return std::min(highest_of(i), maximum);
+            }
+        }
+        return maximum;
+    }
+
+    /**
+     * Passes each field of the histogram to an archive, which saves
+     * it or restores it
+     * @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        archive(counts);
+        archive(total);
+        archive(sum);
+        archive(minimum);
+        archive(maximum);
+    }
+
+    private:
+    std::vector<uint64_t> counts; ///< Values recorded in each bucket, up to the last one used
+    uint64_t total;               ///< Number of values recorded
+    double sum;                   ///< Sum of the values recorded
+    int64_t minimum;              ///< Smallest value recorded
+    int64_t maximum;              ///< Largest value recorded
+
+    /**
+     * Bucket of a value: the value itself below SUB_BUCKETS, then for
+     * each power of two HALF_SUB_BUCKETS buckets of equal width
+     */
+    static size_t index_of(int64_t value){
+        if (value < SUB_BUCKETS){
+            return value;
+        }
+        int shift = (63 - __builtin_clzll(value)) - (SUB_BUCKET_BITS - 1);
+        return shift * HALF_SUB_BUCKETS + (value >> shift);
+    }
+
+    /**
+     * Highest value of a bucket
+     */
+    static int64_t highest_of(size_t index){
+        if (index < size_t(SUB_BUCKETS)){
+            return index;
+        }
+        int shift = index / HALF_SUB_BUCKETS - 1;
+        int64_t sub_bucket = index - shift * HALF_SUB_BUCKETS;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+};
+
+/**
+ * Prints the number of values, the 50th, 90th and 99th percentiles
+ * and the largest value of a histogram
+ * @param os the output stream
+ * @param name name of the values
+ * @param histogram histogram printed
+ */
+inline void print_histogram(std::ostream &os, const char *name,
+                            const latency_histogram &histogram){
+    os << name << ": count " << histogram.count()
+       << ", p50 " << histogram.percentile(50)
+       << ", p90 " << histogram.percentile(90)
+       << ", p99 " << histogram.percentile(99)
+       << ", max " << histogram.max() << std::endl;
+}
+
+#endif // __LATENCY_HISTOGRAM_HPP__
@@ -0,0 +1,226 @@
+/** \brief This header file implements the profiler of the atomic models.
+ *
+ * profiled<ATOMIC>::model wraps an atomic model class: it derives from
+ * it and times each call of its transition, output and time advance
+ * functions, so it can be given to cadmium in its place and its state
+ * is still reached by casting to the atomic model class. The calls
+ * and the wall time of each function of each instance are added to
+ * a profile kept by the profile registry, which prints them sorted
+ * by time once the run is over.
+ *
+ * Profiling is opt-in: models built without the wrapper are not
+ * timed at all.
+ */
+
+#ifndef __PROFILED_HPP__
+#define __PROFILED_HPP__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cadmium/modeling/message_bag.hpp>
+
+/**
+ * Functions of an atomic model that are timed
+ */
+enum profiled_function{
+    PROFILE_INTERNAL,
+    PROFILE_EXTERNAL,
+    PROFILE_CONFLUENCE,
+    PROFILE_OUTPUT,
+    PROFILE_TIME_ADVANCE,
+    PROFILE_FUNCTIONS
+};
+
+/**
+ * Calls and wall time of each function of one model instance
+ */
+struct model_profile{
+    std::string name;                       ///< Id of the model instance
+    uint64_t calls[PROFILE_FUNCTIONS] = {}; ///< Number of calls of each function
+    int64_t nanoseconds[PROFILE_FUNCTIONS] = {}; ///< Wall time spent in each function
+};
+
+/**
+ * Registry of the profiles of the models built with the wrapper
+ */
+class profile_registry{
+    public:
+    /**
+     * @return the registry of the process
+     */
+    static profile_registry& instance(){
+        static profile_registry registry;
+        return registry;
+    }
+
+    /**
+     * Creates the profile of a model instance
+     * @param name id of the model instance
+     * @return its profile
+     */
+    std::shared_ptr<model_profile> add(const std::string &name){
+        std::shared_ptr<model_profile> profile = std::make_shared<model_profile>();
+        profile->name = name;
+        std::lock_guard<std::mutex> lock(mutex);
+        profiles.push_back(profile);
+        return profile;
+    }
+
+    /**
+     * Prints a row per function of each model instance, sorted by the
+     * time spent in it, and the time of the run spent outside the models
+     * @param os the output stream
+     * @param run_seconds wall time of the run, 0 if it is not known
+     */
+    void report(std::ostream &os, double run_seconds = 0){
+        static const char *FUNCTION_NAMES[PROFILE_FUNCTIONS] = {
+            "internal_transition", "external_transition", "confluence_transition",
+            "output", "time_advance"};
+        struct row{
+            const model_profile *profile;
+            int function;
+        };
+        std::vector<row> rows;
+        double model_seconds = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::shared_ptr<model_profile> &profile : profiles){
+            for (int f = 0; f < PROFILE_FUNCTIONS; f++){
+                if (profile->calls[f]){
+                    rows.push_back({profile.get(), f});
+                    model_seconds += profile->nanoseconds[f] * 1e-9;
+                }
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](const row &a, const row &b){
+            return a.profile->nanoseconds[a.function] > b.profile->nanoseconds[b.function];
+        });
+
+        os << std::left << std::setw(16) << "Model" << std::setw(24) << "Function"
+           << std::right << std::setw(12) << "Calls" << std::setw(14) << "Total (ms)"
+           << std::setw(12) << "ns/call" << std::endl;
+        for (const row &r : rows){
+            uint64_t calls = r.profile->calls[r.function];
+            int64_t ns = r.profile->nanoseconds[r.function];
+            os << std::left << std::setw(16) << r.profile->name
+               << std::setw(24) << FUNCTION_NAMES[r.function] << std::right
+               << std::setw(12) << calls << std::setw(14) << std::fixed
+               << std::setprecision(3) << ns * 1e-6 << std::setw(12)
+               << std::setprecision(1) << double(ns) / calls << std::endl;
+        }
+        os.unsetf(std::ios::floatfield);
+        os << std::setprecision(6) << "Time in the models: " << model_seconds << "sec" << std::endl;
+        if (run_seconds > 0){
+            os << "Time outside the models (engine and logging): "
+               << run_seconds - model_seconds << "sec" << std::endl;
+        }
+    }
+
+    /**
+     * @param function function of the models
+     * @return number of calls of the function by all the models
+     */
+    uint64_t total_calls(profiled_function function){
+        uint64_t calls = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::shared_ptr<model_profile> &profile : profiles){
+            calls += profile->calls[function];
+        }
+        return calls;
+    }
+
+    /**
+     * Forgets the profiles of the previous runs
+     */
+    void clear(){
+        std::lock_guard<std::mutex> lock(mutex);
+        profiles.clear();
+    }
+
+    private:
+    std::mutex mutex;
+    std::vector<std::shared_ptr<model_profile>> profiles;
+};
+
+/**
+ * Wrapper of the atomic model class ATOMIC. profiled<ATOMIC>::model
+ * is an atomic model class that can be given to cadmium.
+ */
+template<template<typename TIME> class ATOMIC>
+struct profiled{
+    template<typename TIME>
+    class model : public ATOMIC<TIME>{
+        using base = ATOMIC<TIME>;
+        using clock = std::chrono::steady_clock;
+        using input_bags = typename cadmium::make_message_bags<typename base::input_ports>::type;
+        using output_bags = typename cadmium::make_message_bags<typename base::output_ports>::type;
+
+        public:
+        /**
+         * Builds the atomic model and registers its profile
+         * @param name id of the model instance in the profile
+         * @param args arguments of the constructor of the atomic model
+         */
+        template<typename... Args>
+        explicit model(const std::string &name, Args&&... args) :
+            base(std::forward<Args>(args)...),
+            profile(profile_registry::instance().add(name)) {}
+
+        void internal_transition(){
+            timer t(*profile, PROFILE_INTERNAL);
+            base::internal_transition();
+        }
+
+        void external_transition(TIME e, input_bags mbs){
+            timer t(*profile, PROFILE_EXTERNAL);
+            base::external_transition(e, std::move(mbs));
+        }
+
+        void confluence_transition(TIME e, input_bags mbs){
+            timer t(*profile, PROFILE_CONFLUENCE);
+            base::confluence_transition(e, std::move(mbs));
+        }
+
+        output_bags output() const{
+            timer t(*profile, PROFILE_OUTPUT);
+            return base::output();
+        }
+
+        TIME time_advance() const{
+            timer t(*profile, PROFILE_TIME_ADVANCE);
+            return base::time_advance();
+        }
+
+        private:
+        std::shared_ptr<model_profile> profile;
+
+        /**
+         * Adds the time from its construction to its destruction
+         * to a function of the profile
+         */
+        struct timer{
+            model_profile &profile;
+            int function;
+            clock::time_point start;
+
+            timer(model_profile &profile, int function) :
+                profile(profile), function(function), start(clock::now()) {}
+
+            ~timer(){
+                profile.calls[function]++;
+                profile.nanoseconds[function] +=
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+            }
+        };
+    };
+};
+
+#endif // __PROFILED_HPP__
@@ -0,0 +1,110 @@
+/** \brief This header file implements the estimator of the retransmission timeout of the senders.
+ *
+ * The senders may adapt their timeout to the round trip times they
+ * measure instead of waiting a constant time, as TCP does (Jacobson
+ * and Karels, RFC 6298). The smoothed round trip time and its mean
+ * deviation are updated with gains of 1/8 and 1/4 by each sample, and
+ * the timeout is the smoothed time plus four deviations. Every
+ * timeout that expires doubles it, until the next sample. Samples are
+ * only taken from packets that were not sent again (Karn's
+ * algorithm), whose acknowledgement cannot be the one of an earlier
+ * transmission. Times are kept in integer milliseconds, the
+ * resolution of the models.
+ */
+
+#ifndef __RTT_ESTIMATOR_HPP__
+#define __RTT_ESTIMATOR_HPP__
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Smallest timeout, as in RFC 6298
+ */
+#define RTT_MIN_TIMEOUT_MS 1000
+
+/**
+ * Largest timeout reached by the backoff
+ */
+#define RTT_MAX_TIMEOUT_MS 60000
+
+/**
+ * Estimator of the retransmission timeout from the round trip times
+ */
+class rtt_estimator{
+    public:
+    /**
+     * @param initial_ms timeout before the first sample, in milliseconds
+     */
+    explicit rtt_estimator(int64_t initial_ms = 20000) :
+        smoothed(0), deviation(0), timeout(clamp(initial_ms)), samples(0) {}
+
+    /**
+     * Updates the estimation with the round trip time of a packet
+     * sent once, and sets the timeout from it
+     * @param rtt_ms round trip time in milliseconds
+     */
+    void sample(int64_t rtt_ms){
+        if (samples == 0){
+            smoothed = rtt_ms;
+            deviation = rtt_ms / 2;
+        } else{
+            int64_t error = rtt_ms - smoothed;
+            deviation += ((error < 0 ? -error : error) - deviation) / 4;
+            smoothed += error / 8;
+        }
+        samples++;
+        timeout = clamp(smoothed + std::max<int64_t>(1, 4 * deviation));
+    }
+
+    /**
+     * Doubles the timeout after it expired
+     */
+    void back_off(){
+        timeout = clamp(2 * timeout);
+    }
+
+    /**
+     * @return the retransmission timeout in milliseconds
+     */
+    int64_t timeout_ms() const{
+        return timeout;
+    }
+
+    /**
+     * @return the smoothed round trip time in milliseconds, 0 before the first sample
+     */
+    int64_t smoothed_ms() const{
+        return smoothed;
+    }
+
+    /**
+     * @return the mean deviation of the round trip time in milliseconds, 0 before the first sample
+     */
+    int64_t deviation_ms() const{
+        return deviation;
+    }
+
+    /** Passes each field to an archive, which saves it or restores it
+     *  @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        archive(smoothed);
+        archive(deviation);
+        archive(timeout);
+        archive(samples);
+    }
+
+    private:
+    int64_t smoothed;  ///< Smoothed round trip time
+    int64_t deviation; ///< Mean deviation of the round trip time
+    int64_t timeout;   ///< Retransmission timeout
+    int64_t samples;   ///< Round trip times sampled
+
+    static int64_t clamp(int64_t ms){
+        return std::min<int64_t>(std::max<int64_t>(ms, RTT_MIN_TIMEOUT_MS), RTT_MAX_TIMEOUT_MS);
+    }
+};
+
+#endif // __RTT_ESTIMATOR_HPP__
@@ -0,0 +1,193 @@
+/** \brief This header file implements the partitioned runner of independent models.
+ *
+ * A model made of coupled models that do not exchange any message,
+ * such as the flows of the multi-flow simulator, is split in
+ * partitions, each one a top model of its own given a copy of the
+ * shared source models that feed all of them, like the control
+ * generator. Each partition is run by its own cadmium runner on the
+ * pool of worker threads up to the next synchronization point, then
+ * the traces the partitions wrote in the meantime are merged in time
+ * order, so the trace is the one of the whole model run by a single
+ * runner, and the next window is run. The worker threads are kept
+ * from one window to the next.
+ *
+ * The loggers of the partitions write to the stream returned by
+ * partition_stream(), which is set for the thread running each
+ * partition and is nullptr outside of the partitioned runner.
+ */
+
+#ifndef __PARTITIONED_RUNNER_HPP__
+#define __PARTITIONED_RUNNER_HPP__
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+
+#include "work_stealing.hpp"
+
+/**
+ * Stream the loggers of the partition run by this thread write to
+ * @return the stream, nullptr if no partition is run by this thread
+ */
+inline std::ostream *&partition_stream(){
+    thread_local std::ostream *stream = nullptr;
+    return stream;
+}
+
+/**
+ * Runner of independent partitions of a model on a pool of threads
+ */
+template<typename TIME, typename LOGGER>
+class partitioned_runner{
+    public:
+    using top_model = std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>>;
+
+    /**
+     * Creates the runner of each partition. The trace written when
+     * they are created is the one of the first partition.
+     * @param partitions top model of each partition
+     * @param init initial time
+     * @param threads number of worker threads
+     * @param shared_model id of the source model copied in every partition
+     * @param trace stream the merged trace is written to, or nullptr
+     */
+    partitioned_runner(const std::vector<top_model> &partitions,
+                       const TIME &init,
+                       unsigned int threads,
+                       const std::string &shared_model,
+                       std::ostream *trace) :
+        pool(threads), shared_model(shared_model), trace(trace), current(init){
+        for (size_t p = 0; p < partitions.size(); p++){
+            traces.emplace_back(new std::ostringstream());
+            partition_stream() = traces[p].get();
+            runners.emplace_back(new cadmium::dynamic::engine::runner<TIME, LOGGER>(partitions[p],
+                                                                                     init));
+            partition_stream() = nullptr;
+        }
+        if (trace && !traces.empty()){
+            *trace << traces[0]->str();
+        }
+        for (std::unique_ptr<std::ostringstream> &partition_trace : traces){
+            partition_trace->str("");
+        }
+    }
+
+    /**
+     * Runs every partition until the given time, synchronizing them
+     * and writing their merged trace after each interval
+     * @param until time the partitions are ran until
+     * @param interval simulated time between synchronization points
+     * @return time of the next event of the model
+     */
+    TIME run_until(const TIME &until, const TIME &interval){
+        std::vector<TIME> next(runners.size(), until);
+        while (current < until){
+            TIME window_end = std::min(current + interval, until);
+            pool.run(runners.size(), [&](size_t p){
+                partition_stream() = traces[p].get();
+                next[p] = runners[p]->run_until(window_end);
+                partition_stream() = nullptr;
+            });
+            if (trace){
+                merge_traces();
+            }
+            current = window_end;
+        }
+        return next.empty() ? until : *std::min_element(next.begin(), next.end());
+    }
+
+    private:
+    /**
+     * Lines logged at one time by one partition
+     */
+    struct block{
+        TIME time;
+        std::vector<std::string> lines; ///< Time line followed by the output lines
+    };
+
+    work_stealing_pool pool;
+    std::string shared_model;
+    std::ostream *trace;
+    TIME current;
+    std::vector<std::unique_ptr<cadmium::dynamic::engine::runner<TIME, LOGGER>>> runners;
+    std::vector<std::unique_ptr<std::ostringstream>> traces;
+
+    /**
+     * Splits the trace of a partition in blocks, each one starting
+     * with a time line
+     */
+    static std::vector<block> split_blocks(const std::string &text){
+        std::vector<block> blocks;
+        std::istringstream is(text);
+        std::string line;
+        while (std::getline(is, line)){
+            if (!line.empty() && std::isdigit(static_cast<unsigned char>(line[0]))){
+                blocks.push_back({TIME(line), {}});
+            } else if (blocks.empty()){
+                continue;
+            }
+            blocks.back().lines.push_back(line);
+        }
+        return blocks;
+    }
+
+    /**
+     * @return true if the line is an output of the shared model
+     */
+    bool is_shared_line(const std::string &line) const{
+        size_t id = line.find_last_of(' ');
+        return id != std::string::npos && line.compare(id + 1, std::string::npos, shared_model) == 0;
+    }
+
+    /**
+     * Writes the blocks of the partitions in time order. Blocks of the
+     * same time are written as one: the time line and the lines of the
+     * shared model once, from the first partition, followed by the
+     * lines of the other models of each partition in partition order,
+     * which is their order in the whole model.
+     */
+    void merge_traces(){
+        std::vector<std::vector<block>> blocks;
+        for (std::unique_ptr<std::ostringstream> &partition_trace : traces){
+            blocks.push_back(split_blocks(partition_trace->str()));
+            partition_trace->str("");
+        }
+        std::vector<size_t> head(blocks.size(), 0);
+        for (;;){
+            bool found = false;
+            TIME time;
+            for (size_t p = 0; p < blocks.size(); p++){
+                if (head[p] < blocks[p].size() && (!found || blocks[p][head[p]].time < time)){
+                    time = blocks[p][head[p]].time;
+                    found = true;
+                }
+            }
+            if (!found){
+                return;
+            }
+            bool first = true;
+            for (size_t p = 0; p < blocks.size(); p++){
+                if (head[p] == blocks[p].size() || time < blocks[p][head[p]].time){
+                    continue;
+                }
+                const std::vector<std::string> &lines = blocks[p][head[p]].lines;
+                for (size_t l = 0; l < lines.size(); l++){
+                    if (first || (l > 0 && !is_shared_line(lines[l]))){
+                        *trace << lines[l] << '\n';
+                    }
+                }
+                first = false;
+                head[p]++;
+            }
+        }
+    }
+};
+
+#endif // __PARTITIONED_RUNNER_HPP__
@@ -0,0 +1,190 @@
+/** \brief This header file implements a work stealing parallel loop.
+ *
+ * The tasks are dealt in contiguous blocks to one queue per worker
+ * thread. A worker takes its own tasks from the back of its queue
+ * and, once it is empty, steals from the front of the queues of
+ * the others, so workers given short tasks help the ones given long
+ * tasks without any central queue.
+ *
+ * The pool keeps its worker threads between loops, for the callers
+ * that run a loop at every synchronization point of a simulation:
+ * the workers wait on a condition variable for the next loop instead
+ * of being created and joined each time.
+ */
+
+#ifndef __WORK_STEALING_HPP__
+#define __WORK_STEALING_HPP__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Queue of the tasks of a worker
+ */
+struct work_stealing_queue{
+    std::mutex mutex;         ///< Guards the tasks
+    std::deque<size_t> tasks; ///< Indexes of the tasks not started
+
+    /**
+     * Takes the last task of the queue, used by its owner
+     * @param task index of the task taken
+     * @return false if the queue is empty
+     */
+    bool pop(size_t &task){
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()){
+            return false;
+        }
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    /**
+     * Takes the first task of the queue, used by the other workers
+     * @param task index of the task taken
+     * @return false if the queue is empty
+     */
+    bool steal(size_t &task){
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()){
+            return false;
+        }
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+};
+
+/**
+ * Pool of worker threads running loops with work stealing. The thread
+ * calling run is the first worker, so a pool of one thread runs the
+ * tasks in order on the calling thread without starting any thread.
+ */
+class work_stealing_pool{
+    public:
+    /**
+     * Starts the worker threads, which wait for the first loop
+     * @param threads number of workers, the calling thread included
+     */
+    explicit work_stealing_pool(unsigned int threads) :
+        queues(threads == 0 ? 1 : threads), current(nullptr), loop(0), busy(0), stopping(false){
+        for (unsigned int w = 1; w < queues.size(); w++){
+            workers.emplace_back(&work_stealing_pool::wait_for_loops, this, w);
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    /**
+     * Stops and joins the worker threads
+     */
+    ~work_stealing_pool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for (std::thread &worker : workers){
+            worker.join();
+        }
+    }
+
+    /**
+     * Calls task(i) for every i in [0, count) on the workers. Returns
+     * when all the tasks are done.
+     * @param count number of tasks
+     * @param task function called with the index of each task
+     */
+    void run(size_t count, const std::function<void(size_t)> &task){
+        unsigned int threads = queues.size();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < count; i++){
+                queues[i * threads / count].tasks.push_back(i);
+            }
+            current = &task;
+            busy = workers.size();
+            loop++;
+        }
+        start.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]{ return busy == 0; });
+        current = nullptr;
+    }
+
+    private:
+    std::vector<work_stealing_queue> queues;         ///< Tasks of each worker
+    std::vector<std::thread> workers;                ///< Threads of the workers but the first
+    std::mutex mutex;                                ///< Guards the fields below
+    std::condition_variable start;                   ///< Notified when a loop starts or the pool stops
+    std::condition_variable done;                    ///< Notified when the last worker is done
+    const std::function<void(size_t)> *current;      ///< Task of the current loop
+    unsigned long loop;                              ///< Number of loops started
+    size_t busy;                                     ///< Workers still running the current loop
+    bool stopping;                                   ///< The pool is being destroyed
+
+    /**
+     * Runs the tasks of its queue then steals the ones of the others
+     * @param w index of the worker
+     */
+    void work(unsigned int w){
+        unsigned int threads = queues.size();
+        size_t i;
+        for (;;){
+            bool found = queues[w].pop(i);
+            for (unsigned int v = 1; !found && v < threads; v++){
+                found = queues[(w + v) % threads].steal(i);
+            }
+            if (!found){
+                return;
+            }
+            (*current)(i);
+        }
+    }
+
+    /**
+     * Body of a worker thread: runs every loop until the pool stops
+     * @param w index of the worker
+     */
+    void wait_for_loops(unsigned int w){
+        unsigned long seen = 0;
+        for (;;){
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start.wait(lock, [&]{ return stopping || loop != seen; });
+                if (stopping){
+                    return;
+                }
+                seen = loop;
+            }
+            work(w);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0){
+                done.notify_one();
+            }
+        }
+    }
+};
+
+/**
+ * Calls task(i) for every i in [0, count) on a pool of threads
+ * with work stealing. Returns when all the tasks are done.
+ * @param count number of tasks
+ * @param threads number of worker threads
+ * @param task function called with the index of each task
+ */
+template<typename TASK>
+void parallel_for_work_stealing(size_t count, unsigned int threads, TASK task){
+    work_stealing_pool pool(threads);
+    pool.run(count, task);
+}
+
+#endif // __WORK_STEALING_HPP__
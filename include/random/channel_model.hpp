@@ -0,0 +1,336 @@
+/** \brief This header file implements the loss models and the delay distributions of the subnets.
+ *
+ * A subnet draws the fate of each packet from its loss model and its
+ * delay from its delay distribution, with its own random generator.
+ * The losses are independent (Bernoulli), or come in bursts with the
+ * two states of the Gilbert-Elliott channel, each with its own pass
+ * probability. The delays are constant, normal, exponential, Pareto,
+ * or drawn from the samples of a file, and are rounded to a
+ * resolution in milliseconds, a second by default.
+ *
+ * Each model is a plain structure and the model of a subnet is one of
+ * them held in a std::variant, chosen when the subnet is built, so a
+ * draw is a switch on the alternative and an inlined call, with no
+ * virtual function. The state a model keeps between draws is passed
+ * to the archives of the checkpoints by its serialize function.
+ */
+
+#ifndef __CHANNEL_MODEL_HPP__
+#define __CHANNEL_MODEL_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+#include "random_generator.hpp"
+
+/**
+ * Longest delay drawn, in seconds, so the heavy tail of a Pareto
+ * delay is always a valid time
+ */
+#define CHANNEL_MAX_DELAY_SECONDS 86400.0
+
+/**
+ * Delay distributions of the subnets
+ */
+enum delay_distribution{
+    DELAY_NORMAL,      ///< normal delay, the default
+    DELAY_CONSTANT,    ///< the mean delay for every packet
+    DELAY_EXPONENTIAL, ///< exponential delay of the mean delay
+    DELAY_PARETO,      ///< Pareto delay of the mean delay and a shape
+    DELAY_EMPIRICAL    ///< delay drawn from the samples of a file
+};
+
+/**
+ * Independent losses: each packet is passed with the same probability
+ */
+struct bernoulli_loss{
+    double pass_probability; ///< Probability of a packet to be passed
+
+    bool pass(random_generator &generator){
+        return generator.uniform() < pass_probability;
+    }
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &){}
+};
+
+/**
+ * Bursts of losses: the channel is good or bad, and moves from one
+ * state to the other before each packet, which is then passed with
+ * the probability of the state. The mean length of a burst is
+ * 1 / exit_bad packets.
+ */
+struct gilbert_elliott_loss{
+    double pass_good;   ///< Probability of a packet to be passed in the good state
+    double pass_bad;    ///< Probability of a packet to be passed in the bad state
+    double enter_bad;   ///< Probability of the good state to become bad
+    double exit_bad;    ///< Probability of the bad state to become good
+    bool bad = false;   ///< The channel is in the bad state
+
+    bool pass(random_generator &generator){
+        bad = generator.uniform() < (bad ? 1 - exit_bad : enter_bad);
+        return generator.uniform() < (bad ? pass_bad : pass_good);
+    }
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        archive(bad);
+    }
+};
+
+/**
+ * Delay of the same number of seconds for every packet
+ */
+struct constant_delay{
+    double seconds; ///< Delay in seconds
+
+    double draw(random_generator &){
+        return seconds;
+    }
+
+    double max_seconds() const{
+        return seconds;
+    }
+
+    void reset(){}
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &){}
+};
+
+/**
+ * Normal delay, the delay of the original subnet. The distribution
+ * keeps the second value of each pair it draws for its next draw.
+ */
+struct normal_delay{
+    std::normal_distribution<double> seconds; ///< Delay distribution in seconds
+
+    double draw(random_generator &generator){
+        return seconds(generator);
+    }
+
+    double max_seconds() const{
+        return std::numeric_limits<double>::infinity();
+    }
+
+    void reset(){
+        seconds.reset();
+    }
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        archive(seconds);
+    }
+};
+
+/**
+ * Exponential delay, drawn by inversion
+ */
+struct exponential_delay{
+    double mean; ///< Mean delay in seconds
+
+    double draw(random_generator &generator){
+        return -mean * std::log1p(-generator.uniform());
+    }
+
+    double max_seconds() const{
+        return std::numeric_limits<double>::infinity();
+    }
+
+    void reset(){}
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &){}
+};
+
+/**
+ * Pareto delay, heavy tailed, drawn by inversion. Its mean is
+ * scale * shape / (shape - 1) when the shape is above 1, and its
+ * variance is infinite when the shape is at most 2.
+ */
+struct pareto_delay{
+    double scale; ///< Smallest delay in seconds
+    double shape; ///< Tail index, the smaller the heavier the tail
+
+    double draw(random_generator &generator){
+        return scale / std::pow(1 - generator.uniform(), 1 / shape);
+    }
+
+    double max_seconds() const{
+        return std::numeric_limits<double>::infinity();
+    }
+
+    void reset(){}
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &){}
+};
+
+/**
+ * Delay drawn uniformly from the samples of a measured link. The
+ * samples are shared by all the subnets and never copied.
+ */
+struct empirical_delay{
+    std::shared_ptr<const std::vector<double>> samples; ///< Delays in seconds, at least one
+
+    double draw(random_generator &generator){
+        size_t i = size_t(generator.uniform() * samples->size());
+        return (*samples)[std::min(i, samples->size() - 1)];
+    }
+
+    double max_seconds() const{
+        return *std::max_element(samples->begin(), samples->end());
+    }
+
+    void reset(){}
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &){}
+};
+
+/**
+ * Loss model of a subnet
+ */
+class loss_model{
+    public:
+    loss_model(const bernoulli_loss &loss = bernoulli_loss{0.95}) : model(loss) {}
+    loss_model(const gilbert_elliott_loss &loss) : model(loss) {}
+
+    /**
+     * Draws the fate of a packet
+     * @param generator random generator of the subnet
+     * @return true if the packet is passed
+     */
+    bool pass(random_generator &generator){
+        return std::visit([&generator](auto &loss){ return loss.pass(generator); }, model);
+    }
+
+    /** Passes the state of the model to an archive
+     *  @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        std::visit([&archive](auto &loss){ loss.serialize(archive); }, model);
+    }
+
+    private:
+    std::variant<bernoulli_loss, gilbert_elliott_loss> model;
+};
+
+/**
+ * Delay distribution of a subnet
+ */
+class delay_model{
+    public:
+    delay_model(const normal_delay &delay = normal_delay{std::normal_distribution<double>(3.0, 1.0)})
+        : model(delay) {}
+    delay_model(const constant_delay &delay) : model(delay) {}
+    delay_model(const exponential_delay &delay) : model(delay) {}
+    delay_model(const pareto_delay &delay) : model(delay) {}
+    delay_model(const empirical_delay &delay) : model(delay) {}
+
+    /**
+     * Draws the delay of a packet
+     * @param generator random generator of the subnet
+     * @return delay in seconds, not clipped
+     */
+    double draw(random_generator &generator){
+        return std::visit([&generator](auto &delay){ return delay.draw(generator); }, model);
+    }
+
+    /**
+     * @return the longest delay drawn in seconds, infinity if the
+     *         distribution is not bounded
+     */
+    double max_seconds() const{
+        return std::visit([](const auto &delay){ return delay.max_seconds(); }, model);
+    }
+
+    /**
+     * Forgets the values the distribution keeps for its next draws,
+     * when the generator is reseeded
+     */
+    void reset(){
+        std::visit([](auto &delay){ delay.reset(); }, model);
+    }
+
+    /** Passes the state of the distribution to an archive
+     *  @param archive callable taking a reference to each field
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        std::visit([&archive](auto &delay){ delay.serialize(archive); }, model);
+    }
+
+    private:
+    std::variant<normal_delay, constant_delay, exponential_delay, pareto_delay,
+                 empirical_delay> model;
+};
+
+/**
+ * Loss model and delay distribution of a subnet, with the bounds
+ * and the resolution of its delays
+ */
+struct subnet_channel{
+    loss_model loss;             ///< Fate of the packets
+    delay_model delay;           ///< Delay of the packets before they are clipped and rounded
+    double delay_min = 0;        ///< Minimum delay in seconds, draws below it are clipped
+    int64_t resolution_ms = 1000; ///< Delays are multiples of this number of milliseconds
+
+    /**
+     * Draws the delay of a packet, clipped to the minimum delay and
+     * rounded to the resolution
+     * @param generator random generator of the subnet
+     * @return delay in milliseconds
+     */
+    int64_t draw_delay_ms(random_generator &generator){
+        return delay_ms(delay.draw(generator));
+    }
+
+    /**
+     * Clips a delay to the minimum delay and rounds it to the resolution
+     * @param seconds delay in seconds
+     * @return delay in milliseconds
+     */
+    int64_t delay_ms(double seconds) const{
+        int64_t steps = std::llround(std::min(seconds, CHANNEL_MAX_DELAY_SECONDS) * 1000 / resolution_ms);
+        return std::max(steps * resolution_ms, min_delay_ms());
+    }
+
+    /**
+     * @return the smallest delay drawn in milliseconds, the minimum
+     *         delay rounded up to the resolution
+     */
+    int64_t min_delay_ms() const{
+        return int64_t(std::ceil(delay_min * 1000 / resolution_ms)) * resolution_ms;
+    }
+};
+
+/**
+ * Reads the samples of an empirical delay, one delay in seconds per
+ * line, as measured on a link
+ * @param file path of the file of samples
+ * @param samples samples read
+ * @return false if the file cannot be read, has no sample or a negative one
+ */
+inline bool read_delay_samples(const char *file, std::vector<double> &samples){
+    std::ifstream is(file);
+    samples.clear();
+    double seconds;
+    while (is >> seconds){
+        if (seconds < 0){
+            return false;
+        }
+        samples.push_back(seconds);
+    }
+    return is.eof() && !samples.empty();
+}
+
+#endif // __CHANNEL_MODEL_HPP__
@@ -0,0 +1,136 @@
+/** \brief This header file implements the random number generator of the atomic models.
+ *
+ * xoshiro256** generator (Blackman and Vigna). Each atomic model
+ * owns its generator in its state, so runs are reproducible from
+ * the seed and models of different simulations can run in parallel
+ * threads without sharing any random state.
+ *
+ * Independent streams of the same seed are obtained with jump(),
+ * which advances the generator 2^128 draws.
+ */
+
+#ifndef __RANDOM_GENERATOR_HPP__
+#define __RANDOM_GENERATOR_HPP__
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Seed used when none is given in the command line
+ */
+#define DEFAULT_RANDOM_SEED 0x5eed0abdULL
+
+/**
+ * xoshiro256** generator. It meets the UniformRandomBitGenerator
+ * requirements so it can be used with the distributions of <random>.
+ */
+class random_generator{
+    public:
+    using result_type = std::uint64_t;
+
+    /**
+     * Constructor seeding the generator and moving it to the given stream
+     * @param seed seed of the generator
+     * @param stream number of independent stream of the seed
+     */
+    explicit random_generator(std::uint64_t seed = DEFAULT_RANDOM_SEED,
+                              unsigned int stream = 0) noexcept{
+        this->seed(seed);
+        for (unsigned int i = 0; i < stream; i++){
+            jump();
+        }
+    }
+
+    /**
+     * Sets the state from the seed expanded with splitmix64, so
+     * close seeds give unrelated states and the state is never zero.
+     * @param seed seed of the generator
+     */
+    void seed(std::uint64_t seed) noexcept{
+        for (std::uint64_t &word : s){
+            seed += 0x9e3779b97f4a7c15ULL;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min(){
+        return 0;
+    }
+
+    static constexpr result_type max(){
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * Next draw of the generator
+     * @return 64 random bits
+     */
+    result_type operator()() noexcept{
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    /**
+     * Uniform draw in [0, 1) built from the 53 upper bits
+     * @return random double
+     */
+    double uniform() noexcept{
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * Advances the generator 2^128 draws, which starts a new
+     * stream that does not overlap the previous one
+     */
+    void jump() noexcept{
+        static const std::uint64_t JUMP[] = {0x180ec6d33cfd0abaULL,
+                                             0xd5a61266f0c9392cULL,
+                                             0xa9582618e03fc9aaULL,
+                                             0x39abdc4529b1661cULL};
+        std::uint64_t t[4] = {0, 0, 0, 0};
+        for (std::uint64_t jump : JUMP){
+            for (int b = 0; b < 64; b++){
+                if (jump & (std::uint64_t(1) << b)){
+                    for (int i = 0; i < 4; i++){
+                        t[i] ^= s[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; i++){
+            s[i] = t[i];
+        }
+    }
+
+    /**
+     * Passes each word of the state to an archive, which saves it
+     * or restores it
+     * @param archive callable taking a reference to each word
+     */
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE &archive){
+        for (std::uint64_t &word : s){
+            archive(word);
+        }
+    }
+
+    private:
+    std::uint64_t s[4]; ///< State of the generator
+
+    static std::uint64_t rotl(std::uint64_t x, int k) noexcept{
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif // __RANDOM_GENERATOR_HPP__
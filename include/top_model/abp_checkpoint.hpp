@@ -0,0 +1,358 @@
+/** \brief This header file implements the checkpoints of the ABP Simulator top model.
+ *
+ * A checkpoint holds the state of a run at a time between two
+ * events: the events before that time have been run, and none of the
+ * events after it. It is a binary file made of a header, with the
+ * time of the checkpoint, followed for each atomic model, in the
+ * order generator, sender, receiver, subnets, by the time of its last
+ * transition, the time of its next one and its state: the state of
+ * the sender with its histograms, of the receiver, either of the
+ * alternating bit or window protocol of the model, of the subnets
+ * with their random generators, and of the generator with the
+ * position of its parser in the input file and the inputs it read.
+ *
+ * The run is restored in a top model built the same way, with
+ * resumable atomic models, and resumed by a runner created at the
+ * time of the checkpoint. A run restored and run until a later time
+ * is the same as the run that was saved run until that time.
+ */
+
+#ifndef __ABP_CHECKPOINT_HPP__
+#define __ABP_CHECKPOINT_HPP__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "../checkpoint/checkpoint_archive.hpp"
+#include "../checkpoint/resumable.hpp"
+#include "abp_top_model.hpp"
+
+#define ABP_CHECKPOINT_MAGIC "ABPCHKPT"
+#define ABP_CHECKPOINT_VERSION 5
+
+/**
+ * Bytes of the header of a checkpoint file
+ */
+#define ABP_CHECKPOINT_HEADER_SIZE 24
+
+/**
+ * Header of a checkpoint file, stored as ABP_CHECKPOINT_HEADER_SIZE
+ * bytes, little endian
+ */
+struct abp_checkpoint_header{
+    char magic[8];        ///< ABP_CHECKPOINT_MAGIC, without its terminating zero
+    uint32_t version;     ///< ABP_CHECKPOINT_VERSION
+    uint32_t model_count; ///< number of atomic models following the header
+    int64_t time;         ///< time of the checkpoint in milliseconds
+
+    /**
+     * Stores the header, little endian
+     */
+    void encode(char *bytes) const{
+        memcpy(bytes, magic, sizeof(magic));
+        store_little_endian(version, bytes + 8, 4);
+        store_little_endian(model_count, bytes + 12, 4);
+        store_little_endian(uint64_t(time), bytes + 16, 8);
+    }
+
+    /**
+     * Loads the header stored by encode
+     */
+    void decode(const char *bytes){
+        memcpy(magic, bytes, sizeof(magic));
+        version = static_cast<uint32_t>(load_little_endian(bytes + 8, 4));
+        model_count = static_cast<uint32_t>(load_little_endian(bytes + 12, 4));
+        time = static_cast<int64_t>(load_little_endian(bytes + 16, 8));
+    }
+};
+
+/**
+ * Atomic models of the top model, in the order of the checkpoint
+ */
+#define ABP_CHECKPOINT_MODELS 5
+
+/**
+ * Passes the state of the sender to an archive
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, Sender<TIME> &sender){
+    typename Sender<TIME>::state_type &state = sender.state;
+    archive(state.ack);
+    archive(state.packet_num);
+    archive(state.total_packet_num);
+    archive(state.alt_bit);
+    archive(state.sending);
+    archive(state.model_active);
+    archive(state.next_internal);
+    archive(state.packets_delivered);
+    archive(state.packets_sent);
+    archive(state.retransmissions);
+    archive(state.clock);
+    archive(state.last_delivery_time);
+    archive(state.packet_sent);
+    archive(state.packet_sent_time);
+    archive(state.packet_retransmissions);
+    archive(state.latency);
+    archive(state.packet_retransmission_counts);
+    archive(state.rtt);
+    archive(state.rto);
+}
+
+/**
+ * Passes the state of the window sender to an archive
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, WindowSender<TIME> &sender){
+    typename WindowSender<TIME>::state_type &state = sender.state;
+    archive(state.total_packet_num);
+    archive(state.base);
+    archive(state.next_packet);
+    archive(state.resend);
+    archive(state.resend_queue);
+    archive(state.window);
+    archive(state.packet_num);
+    archive(state.sending);
+    archive(state.send_time);
+    archive(state.timer);
+    archive(state.acknowledged);
+    archive(state.model_active);
+    archive(state.next_internal);
+    archive(state.clock);
+    archive(state.packets_delivered);
+    archive(state.packets_sent);
+    archive(state.retransmissions);
+    archive(state.last_delivery_time);
+    archive(state.latency);
+    archive(state.packet_retransmission_counts);
+    archive(state.rtt);
+    archive(state.rto);
+    if (state.window.size() != uint64_t(sender.WINDOW)){
+        archive.fail();
+    }
+}
+
+/**
+ * Passes the state of the window receiver to an archive
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, WindowReceiver<TIME> &receiver){
+    typename WindowReceiver<TIME>::state_type &state = receiver.state;
+    archive(state.expected);
+    archive(state.buffered);
+    archive(state.acks);
+    archive(state.next_internal);
+    archive(state.packets_received);
+    archive(state.duplicates);
+    if (state.buffered.size() != uint64_t(receiver.WINDOW)){
+        archive.fail();
+    }
+}
+
+/**
+ * Passes the state of the receiver to an archive
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, Receiver<TIME> &receiver){
+    archive(receiver.state.ack);
+    archive(receiver.state.sending);
+    archive(receiver.state.packets_received);
+    archive(receiver.state.duplicates);
+}
+
+/**
+ * Passes the state of a subnet to an archive, with its random
+ * generator, the values its loss model and its delay distribution
+ * keep, and the packets on its link
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, Subnet<TIME> &subnet){
+    typename Subnet<TIME>::state_type &state = subnet.state;
+    archive(state.transmiting);
+    archive(state.packet);
+    archive(state.index);
+    archive(state.lost);
+    archive(state.pass);
+    archive(state.delay);
+    archive(state.generator);
+    archive(state.channel.loss);
+    archive(state.channel.delay);
+    archive(state.clock);
+    archive(state.packets);
+    archive(state.link_free);
+    archive(state.waiting);
+    archive(state.dropped);
+    archive(state.queue_depth);
+}
+
+/**
+ * Passes the state of the generator to an archive, with the position
+ * of the next input in its input file. The input file must be the
+ * one of the run saved.
+ */
+template<typename ARCHIVE, typename TIME>
+void checkpoint_state(ARCHIVE &archive, ApplicationGen<TIME> &generator){
+    typename ApplicationGen<TIME>::state_type &state = generator.state;
+    uint64_t offset = state._parser.offset();
+    archive(offset);
+    if (!state._parser.seek(offset)){
+        archive.fail();
+    }
+    archive(state._last_input_read);
+    archive(state._next_input);
+    archive(state._simulation_time);
+    archive(state._next_time);
+    archive(state._next_time2);
+    archive(state._initialization);
+}
+
+/**
+ * @param atomic atomic model
+ * @param last time of its last transition
+ * @return time of its next internal transition, infinity if it is passive
+ */
+template<typename MODEL, typename TIME>
+TIME next_transition(const MODEL &atomic, const TIME &last){
+    TIME advance = atomic.time_advance();
+    return advance == std::numeric_limits<TIME>::infinity() ? advance : last + advance;
+}
+
+/**
+ * Passes an atomic model to an archive: the time of its last
+ * transition, the time of its next one and its state. When restored
+ * the model is resumed at the time of the checkpoint, which must be
+ * between both times.
+ * @param archive checkpoint_writer or checkpoint_reader
+ * @param model resumable atomic model
+ * @param time time of the checkpoint
+ */
+template<template<typename T> class ATOMIC, typename TIME, typename ARCHIVE>
+void checkpoint_model(ARCHIVE &archive,
+                      const std::shared_ptr<cadmium::dynamic::modeling::model> &model,
+                      const TIME &time){
+    using wrapped = typename resumable<ATOMIC>::template model<TIME>;
+    wrapped *resumed = dynamic_cast<wrapped*>(model.get());
+    if (!resumed){
+        archive.fail();
+        return;
+    }
+    ATOMIC<TIME> &atomic = *resumed;
+    TIME last = resumed->last_transition();
+    TIME next = next_transition(atomic, last);
+    archive(last);
+    archive(next);
+    checkpoint_state(archive, atomic);
+    if (ARCHIVE::restoring){
+        // the times saved must be the ones of the state saved
+        TIME restored_next = next_transition(atomic, last);
+        if (!archive.good() || time < last || restored_next < time || !(restored_next == next)){
+            archive.fail();
+            return;
+        }
+        resumed->resume(last, time);
+    }
+}
+
+/**
+ * Passes the atomic models of the top model to an archive, the
+ * window sender and receiver if the model was built with them
+ */
+template<typename TIME, typename ARCHIVE>
+void checkpoint_models(ARCHIVE &archive, const abp_top_model<TIME> &model, const TIME &time){
+    checkpoint_model<ApplicationGen>(archive, model.generator, time);
+    if (dynamic_cast<WindowSender<TIME>*>(model.sender.get())){
+        checkpoint_model<WindowSender>(archive, model.sender, time);
+        checkpoint_model<WindowReceiver>(archive, model.receiver, time);
+    } else{
+        checkpoint_model<Sender>(archive, model.sender, time);
+        checkpoint_model<Receiver>(archive, model.receiver, time);
+    }
+    checkpoint_model<Subnet>(archive, model.subnet1, time);
+    checkpoint_model<Subnet>(archive, model.subnet2, time);
+}
+
+/**
+ * Saves the state of a run at a time between two events. The file is
+ * written aside and renamed, so a run stopped while saving leaves the
+ * previous checkpoint as it was.
+ * @param file path of the checkpoint file
+ * @param model top model built by make_abp_top_model with checkpointable models
+ * @param time time the run was run until
+ * @return false if the checkpoint cannot be written
+ */
+template<typename TIME>
+bool save_abp_checkpoint(const char *file, const abp_top_model<TIME> &model, const TIME &time){
+    std::string written = std::string(file) + ".tmp";
+    {
+        std::ofstream os(written, std::ios::binary | std::ios::trunc);
+        abp_checkpoint_header header;
+        memcpy(header.magic, ABP_CHECKPOINT_MAGIC, sizeof(header.magic));
+        header.version = ABP_CHECKPOINT_VERSION;
+        header.model_count = ABP_CHECKPOINT_MODELS;
+        header.time = time_to_milliseconds(time);
+        char bytes[ABP_CHECKPOINT_HEADER_SIZE];
+        header.encode(bytes);
+        os.write(bytes, sizeof(bytes));
+        checkpoint_writer<TIME> writer(os);
+        checkpoint_models(writer, model, time);
+        os.flush();
+        if (!writer.good()){
+            std::remove(written.c_str());
+            return false;
+        }
+    }
+    return std::rename(written.c_str(), file) == 0;
+}
+
+/**
+ * Restores the state of a run saved by save_abp_checkpoint
+ * @param file path of the checkpoint file
+ * @param model top model built by make_abp_top_model with checkpointable
+ *              models and the input file of the run saved, not run yet
+ * @param time time of the checkpoint, the runner is created at it
+ * @return false if the file is not a valid checkpoint of the model
+ */
+template<typename TIME>
+bool restore_abp_checkpoint(const char *file, const abp_top_model<TIME> &model, TIME &time){
+    std::ifstream is(file, std::ios::binary);
+    char bytes[ABP_CHECKPOINT_HEADER_SIZE];
+    if (!is.read(bytes, sizeof(bytes))){
+        return false;
+    }
+    abp_checkpoint_header header;
+    header.decode(bytes);
+    if (memcmp(header.magic, ABP_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ABP_CHECKPOINT_VERSION ||
+        header.model_count != ABP_CHECKPOINT_MODELS ||
+        header.time < 0 || header.time == CHECKPOINT_INFINITY){
+        return false;
+    }
+    time = time_from_milliseconds<TIME>(header.time);
+    checkpoint_reader<TIME> reader(is);
+    checkpoint_models(reader, model, time);
+    return reader.good() && is.peek() == std::char_traits<char>::eof();
+}
+
+/**
+ * Reseeds the subnets of a restored run, as make_abp_top_model seeds
+ * them, so a run can be branched from a checkpoint into runs that
+ * draw different losses and delays from the time of the checkpoint
+ * @param model top model restored by restore_abp_checkpoint
+ * @param seed seed of the random generators of the subnets
+ */
+template<typename TIME>
+void reseed_abp_subnets(const abp_top_model<TIME> &model, uint64_t seed){
+    Subnet<TIME> *subnets[] = {
+        std::dynamic_pointer_cast<Subnet<TIME>>(model.subnet1).get(),
+        std::dynamic_pointer_cast<Subnet<TIME>>(model.subnet2).get()
+    };
+    for (unsigned int stream = 0; stream < 2; stream++){
+        subnets[stream]->state.generator = random_generator(seed, stream);
+        subnets[stream]->state.channel.delay.reset();
+    }
+}
+
+#endif // __ABP_CHECKPOINT_HPP__
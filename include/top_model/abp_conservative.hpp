@@ -0,0 +1,692 @@
+/** \brief This header file implements the conservative parallel run of many ABP flows.
+ *
+ * The multi-flow model is split in two logical processes, each one run
+ * on its own thread: the endpoints, made of the control generator and
+ * the sender and the receiver of every flow, and the network, made of
+ * the subnets of every flow. The endpoints are a top model run by a
+ * cadmium runner, and their messages go through a proxy atomic model
+ * of each flow. The subnets are not coupled to each other, so the
+ * network runs them directly by their transition functions in the
+ * order of their events, which spares it the visit of every subnet at
+ * every step.
+ *
+ * A subnet never delivers a packet sooner than its minimum delay after
+ * receiving it, which is the lookahead of the network. When a subnet
+ * receives a packet that is not lost it announces the packet and the
+ * time it will deliver it, so the endpoints may run up to a lookahead
+ * ahead of the network. Without a queue, a packet received while the
+ * subnet is still transmitting replaces the one transmitted, so the
+ * proxy of the flow drops an announced delivery when the endpoints
+ * sent that subnet another packet before it; with a queue every
+ * delivery announced is made. The network runs up to the earliest time
+ * the endpoints may send it a message. Both processes run a window at
+ * the same time and exchange their messages at the end of it, and the
+ * results are the ones of the sequential run of the same flows.
+ *
+ * The network runs on a thread of its own, started once for the whole
+ * run, and the endpoints on the calling thread; the two threads meet
+ * at the end of every window on a condition variable, since windows
+ * are short and many.
+ */
+
+#ifndef __ABP_CONSERVATIVE_HPP__
+#define __ABP_CONSERVATIVE_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "abp_flows.hpp"
+
+/**
+ * Channels of a flow between the endpoints and the network
+ */
+enum abp_channel{
+    DATA_CHANNEL, ///< Packets from the sender to the receiver, through the first subnet
+    ACK_CHANNEL,  ///< Acknowledgements from the receiver to the sender, through the second subnet
+    ABP_CHANNELS
+};
+
+/**
+ * Message sent from one logical process to the other
+ */
+template<typename TIME>
+struct abp_link_message{
+    TIME time;           ///< Time the message is received
+    TIME sent;           ///< Time the message was sent, into the subnet for a delivery
+    uint64_t flow;       ///< Index of the flow in the model, from 0
+    abp_channel channel; ///< Channel of the flow
+    message_t message;
+};
+
+/**
+ * State shared by the proxies of both logical processes and the
+ * driver, which only changes it between windows
+ */
+template<typename TIME>
+struct abp_link{
+    TIME lookahead;     ///< Minimum delay of the subnets
+    TIME network_time;  ///< Time the network was run until before the window
+    std::vector<abp_link_message<TIME>> to_network;   ///< Messages sent by the endpoints in the window
+    std::vector<abp_link_message<TIME>> to_endpoints; ///< Deliveries announced by the network in the window
+};
+
+/**
+ * Structure Port definition of the proxy of a flow in the endpoints
+ */
+struct endpoint_proxy_defs{
+    struct data_in : public cadmium::in_port<message_t> {};   ///< Packets sent by the sender
+    struct ack_in : public cadmium::in_port<message_t> {};    ///< Acknowledgements sent by the receiver
+    struct data_out : public cadmium::out_port<message_t> {}; ///< Packets delivered to the receiver
+    struct ack_out : public cadmium::out_port<message_t> {};  ///< Acknowledgements delivered to the sender
+};
+
+/**
+ * Proxy of the network of a flow in the endpoints. It sends the
+ * messages of the sender and the receiver to the network and
+ * delivers the messages announced by the network at their time.
+ * After each message sent it wakes up once a lookahead has passed,
+ * when the delivery of that message, if any, is known.
+ */
+template<typename TIME>
+class endpoint_proxy{
+    using defs = endpoint_proxy_defs;
+    public:
+    abp_link<TIME> *link; ///< Link of the logical processes
+    uint64_t flow;        ///< Index of the flow
+    bool replacing;       ///< The subnets have no queue, a packet replaces the one transmitted
+
+    /**
+     * Constructor of the proxy of a flow
+     * @param link link of the logical processes
+     * @param flow index of the flow, from 0
+     * @param replacing true if the subnets of the flow have no queue
+     */
+    endpoint_proxy(abp_link<TIME> *link, uint64_t flow, bool replacing = true) noexcept 
+        : link(link), flow(flow), replacing(replacing){
+        state.clock = TIME();
+        state.next = std::numeric_limits<TIME>::infinity();
+    }
+
+    /**
+     * Structure state definition
+     */
+    struct state_type{
+        TIME clock; ///< Time of the last transition
+        TIME next;  ///< Time of the next internal transition
+        std::deque<abp_link_message<TIME>> deliveries; ///< Deliveries announced, in time order
+        std::deque<TIME> sent[ABP_CHANNELS]; ///< Times messages were sent to each subnet not yet reached by the network
+    }; state_type state;
+    using input_ports = std::tuple<typename defs::data_in, typename defs::ack_in>;
+    using output_ports = std::tuple<typename defs::data_out, typename defs::ack_out>;
+
+    /**
+     * Adds a delivery announced by the network, unless the subnet
+     * has no queue and received another message after the one
+     * delivered and before the delivery, which replaced it
+     * @param message delivery announced
+     */
+    void deliver(const abp_link_message<TIME> &message){
+        for (const TIME &sent : state.sent[message.channel]){
+            if (replacing && message.sent < sent && sent < message.time){
+                return;
+            }
+        }
+        auto position = std::upper_bound(state.deliveries.begin(), state.deliveries.end(), message,
+                                         [](const abp_link_message<TIME> &a,
+                                            const abp_link_message<TIME> &b){
+                                             return a.time < b.time;
+                                         });
+        state.deliveries.insert(position, message);
+    }
+
+    /**
+     * Internal transition function that drops the deliveries made
+     */
+    void internal_transition(){
+        state.clock = state.next;
+        while (!state.deliveries.empty() && state.deliveries.front().time == state.clock){
+            state.deliveries.pop_front();
+        }
+        schedule();
+    }
+
+    /**
+     * External transition function that sends the messages of the
+     * sender and the receiver to the network, dropping the deliveries
+     * of the messages they replace in the subnets
+     * @param e of type time
+     * @param mbs of type message bags
+     */
+    void external_transition(TIME e,
+                             typename cadmium::make_message_bags<input_ports>::type mbs){
+        state.clock += e;
+        send(DATA_CHANNEL, cadmium::get_messages<typename defs::data_in>(mbs));
+        send(ACK_CHANNEL, cadmium::get_messages<typename defs::ack_in>(mbs));
+        schedule();
+    }
+
+    /**
+     * Confluence transition function that calls internal
+     * transition function followed by external transition function.
+     * @param e of type time
+     * @param mbs of type message bags
+     */
+    void confluence_transition(TIME e,
+                               typename cadmium::make_message_bags<input_ports>::type mbs){
+        internal_transition();
+        external_transition(TIME(), std::move(mbs));
+    }
+
+    /**
+     * Output function that makes the deliveries of this time
+     * @return message bags
+     */
+    typename cadmium::make_message_bags<output_ports>::type output() const{
+        typename cadmium::make_message_bags<output_ports>::type bags;
+        for (const abp_link_message<TIME> &delivery : state.deliveries){
+            if (state.next < delivery.time){
+                break;
+            }
+            if (delivery.channel == DATA_CHANNEL){
+                cadmium::get_messages<typename defs::data_out>(bags).push_back(delivery.message);
+            } else{
+                cadmium::get_messages<typename defs::ack_out>(bags).push_back(delivery.message);
+            }
+        }
+        return bags;
+    }
+
+    /**
+     * time_advance function: the next delivery or the next time
+     * the delivery of a message sent is known
+     * @return Next internal time
+     */
+    TIME time_advance() const{
+        if (state.next == std::numeric_limits<TIME>::infinity()){
+            return state.next;
+        }
+        return state.next - state.clock;
+    }
+
+    private:
+    /**
+     * Sends messages to a subnet
+     */
+    void send(abp_channel channel, const std::vector<message_t> &messages){
+        for (const message_t &message : messages){
+            for (auto delivery = state.deliveries.begin(); 
+                 replacing && delivery != state.deliveries.end();){
+                if (delivery->channel == channel && delivery->sent < state.clock &&
+                    state.clock < delivery->time){
+                    delivery = state.deliveries.erase(delivery);
+                } else{
+                    delivery++;
+                }
+            }
+            state.sent[channel].push_back(state.clock);
+            link->to_network.push_back({state.clock, state.clock, flow, channel, message});
+        }
+    }
+
+    /**
+     * Forgets the messages the network has already received, whose
+     * deliveries are all known, and finds the next internal time
+     */
+    void schedule(){
+        state.next = std::numeric_limits<TIME>::infinity();
+        if (!state.deliveries.empty()){
+            state.next = state.deliveries.front().time;
+        }
+        for (std::deque<TIME> &sent : state.sent){
+            while (!sent.empty() && sent.front() < link->network_time){
+                sent.pop_front();
+            }
+            for (const TIME &time : sent){
+                TIME known = time + link->lookahead;
+                if (state.clock < known){
+                    state.next = std::min(state.next, known);
+                    break;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * The network logical process. Its subnets are not coupled to each
+ * other, so they are run directly by their transition functions, in
+ * the order of their events, instead of by a coordinator visiting all
+ * of them at every step. When a subnet receives a packet that it will
+ * deliver, the packet and its delivery time are announced to the
+ * endpoints.
+ */
+template<typename TIME>
+class network_process{
+    public:
+    /**
+     * Creates the process without subnets
+     * @param link link of the logical processes
+     */
+    explicit network_process(abp_link<TIME> *link) : link(link){}
+
+    /**
+     * Adds the subnets of the next flow
+     * @param subnet1 subnet of the data channel
+     * @param subnet2 subnet of the acknowledgement channel
+     */
+    void add_flow(Subnet<TIME> *subnet1, Subnet<TIME> *subnet2){
+        for (Subnet<TIME> *subnet : {subnet1, subnet2}){
+            subnets.push_back({subnet, TIME(), TIME()});
+            schedule(subnets.size() - 1, TIME());
+        }
+    }
+
+    /**
+     * Adds a message sent by the endpoints, later than the ones added before
+     * @param message message sent
+     */
+    void deliver(const abp_link_message<TIME> &message){
+        inputs.push_back(message);
+    }
+
+    /**
+     * @return true if no message of the endpoints is waiting
+     */
+    bool idle() const{
+        return inputs.empty();
+    }
+
+    /**
+     * Runs the transitions of the subnets up to the given time, excluded
+     * @param until time the process is ran until
+     */
+    void run_until(const TIME &until){
+        for (;;){
+            while (!events.empty() && subnets[events.top().second].next != events.top().first){
+                events.pop();
+            }
+            TIME time = std::numeric_limits<TIME>::infinity();
+            if (!events.empty()){
+                time = events.top().first;
+            }
+            if (!inputs.empty()){
+                time = std::min(time, inputs.front().time);
+            }
+            if (!(time < until)){
+                return;
+            }
+            // subnets receiving a message, with the confluent ones
+            while (!inputs.empty() && inputs.front().time == time){
+                const abp_link_message<TIME> &message = inputs.front();
+                size_t s = 2 * message.flow + message.channel;
+                typename cadmium::make_message_bags<typename Subnet<TIME>::input_ports>::type bags;
+                cadmium::get_messages<subnet_defs::in>(bags).push_back(message.message);
+                subnet_state &subnet = subnets[s];
+                if (subnet.next == time){
+                    subnet.model->confluence_transition(time - subnet.last, std::move(bags));
+                } else{
+                    subnet.model->external_transition(time - subnet.last, std::move(bags));
+                }
+                const typename Subnet<TIME>::state_type &state = subnet.model->state;
+                if (state.transmiting && state.pass){
+                    link->to_endpoints.push_back({time + state.delay, time, message.flow,
+                                                  message.channel, state.packet});
+                }
+                schedule(s, time);
+                inputs.pop_front();
+            }
+            // the other imminent subnets, those rescheduled above are skipped
+            while (!events.empty() && events.top().first == time){
+                size_t s = events.top().second;
+                events.pop();
+                if (subnets[s].next == time){
+                    subnets[s].model->internal_transition();
+                    schedule(s, time);
+                }
+            }
+        }
+    }
+
+    private:
+    /**
+     * Subnet and the times of its last and next transitions
+     */
+    struct subnet_state{
+        Subnet<TIME> *model;
+        TIME last;
+        TIME next;
+    };
+    using event = std::pair<TIME, size_t>; ///< Time of the next transition of a subnet
+
+    abp_link<TIME> *link;
+    std::vector<subnet_state> subnets; ///< Subnets of flow n at 2 n and 2 n + 1
+    std::deque<abp_link_message<TIME>> inputs; ///< Messages of the endpoints not received yet, in time order
+    std::priority_queue<event, std::vector<event>, std::greater<event>> events; ///< Next transitions, some outdated
+
+    /**
+     * Sets the time of the last transition of a subnet and schedules its next one
+     */
+    void schedule(size_t s, const TIME &time){
+        subnet_state &subnet = subnets[s];
+        subnet.last = time;
+        TIME advance = subnet.model->time_advance();
+        if (advance == std::numeric_limits<TIME>::infinity()){
+            subnet.next = advance;
+        } else{
+            subnet.next = time + advance;
+            events.push({subnet.next, s});
+        }
+    }
+};
+
+/**
+ * Structure that holds the two logical processes together with the
+ * atomic models of the flows and the proxies of the endpoints.
+ */
+template<typename TIME>
+struct abp_conservative_model{
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> endpoints; ///< Top model of the endpoints
+    std::shared_ptr<network_process<TIME>> network;
+    std::vector<abp_flow<TIME>> flows; ///< Atomic models of each flow, simulator is not set
+    std::vector<std::shared_ptr<endpoint_proxy<TIME>>> endpoint_proxies;
+    std::shared_ptr<abp_link<TIME>> link;
+};
+
+/**
+ * Builds the flows of the groups as the two logical processes. The
+ * models of flow n have the ids and the parameters they have in
+ * make_abp_flows_model, and the same random streams, and its proxy
+ * is endpoint_proxy<n>. The lookahead is the
+ * smallest minimum delay of the subnets, rounded up to the resolution
+ * of their delays, which must be positive.
+ * @param input_file path of the input file of the control generator
+ * @param groups groups of flows
+ * @param seed seed of the random generators of the subnets
+ * @return the top models of the logical processes and their models
+ */
+template<typename TIME>
+abp_conservative_model<TIME> make_abp_conservative_model(const char *input_file,
+                                                         const std::vector<abp_flow_group> &groups,
+                                                         uint64_t seed = DEFAULT_RANDOM_SEED){
+    abp_conservative_model<TIME> model;
+    model.link = std::make_shared<abp_link<TIME>>();
+    abp_link<TIME> *link = model.link.get();
+    int64_t delay_min = std::numeric_limits<int64_t>::max();
+    uint64_t count = 0;
+    for (const abp_flow_group &group : groups){
+        // the subnets round their delays to their resolution, their minimum up
+        delay_min = std::min(delay_min, 
+                             make_abp_channel(to_parameters<TIME>(group.parameters)).min_delay_ms());
+        count += group.flows;
+    }
+    link->lookahead = time_from_milliseconds<TIME>(delay_min);
+    link->network_time = TIME();
+    if (link->lookahead <= TIME()){
+        throw std::invalid_argument("the minimum delay of the subnets must be positive");
+    }
+
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator_con =
+                    cadmium::dynamic::translate::make_dynamic_atomic_model
+                    <ApplicationGen,
+                     TIME,
+                     const char* >("generator_con",
+                                   std::move(input_file)
+                                   );
+    cadmium::dynamic::modeling::Models submodels_endpoints = {generator_con};
+    cadmium::dynamic::modeling::EOCs eocs_endpoints;
+    cadmium::dynamic::modeling::ICs ics_endpoints;
+    submodels_endpoints.reserve(3 * count + 1);
+    eocs_endpoints.reserve(2 * count);
+    ics_endpoints.reserve(5 * count);
+    model.network = std::make_shared<network_process<TIME>>(link);
+    model.flows.reserve(count);
+
+    random_generator generator(seed, 0);
+    uint64_t flow = 0;
+    for (const abp_flow_group &group : groups){
+        abp_parameters<TIME> parameters = to_parameters<TIME>(group.parameters);
+        for (uint64_t g = 0; g < group.flows; g++, flow++){
+            std::string n = std::to_string(flow + 1);
+            std::string sender_id = "sender" + n;
+            std::string receiver_id = "receiver" + n;
+            std::string subnet1_id = "subnet" + std::to_string(2 * flow + 1);
+            std::string subnet2_id = "subnet" + std::to_string(2 * flow + 2);
+            std::string endpoint_proxy_id = "endpoint_proxy" + n;
+            random_generator next_stream = generator;
+            next_stream.jump();
+
+            abp_flow<TIME> atomics;
+            atomics.sender = make_abp_sender<TIME>(parameters, false, false, sender_id.c_str());
+            atomics.receiver = make_abp_receiver<TIME>(parameters, false, false,
+                                                       receiver_id.c_str());
+            atomics.subnet1 = cadmium::dynamic::translate::make_dynamic_atomic_model
+                              <Subnet, TIME, random_generator, subnet_channel, subnet_queue>(
+                                  subnet1_id,
+                                  random_generator(generator),
+                                  make_abp_channel(parameters),
+                                  make_abp_queue(parameters));
+            atomics.subnet2 = cadmium::dynamic::translate::make_dynamic_atomic_model
+                              <Subnet, TIME, random_generator, subnet_channel, subnet_queue>(
+                                  subnet2_id,
+                                  std::move(next_stream),
+                                  make_abp_channel(parameters),
+                                  make_abp_queue(parameters));
+            std::shared_ptr<cadmium::dynamic::modeling::model> endpoints_side =
+                cadmium::dynamic::translate::make_dynamic_atomic_model
+                <endpoint_proxy, TIME, abp_link<TIME>*, uint64_t, bool>(endpoint_proxy_id,
+                                                                        std::move(link),
+                                                                        uint64_t(flow),
+                                                                        parameters.queue_capacity == 0);
+            model.endpoint_proxies.push_back(
+                std::dynamic_pointer_cast<endpoint_proxy<TIME>>(endpoints_side));
+            model.network->add_flow(dynamic_cast<Subnet<TIME>*>(atomics.subnet1.get()),
+                                    dynamic_cast<Subnet<TIME>*>(atomics.subnet2.get()));
+            // the subnets of the next flow draw from the next two streams
+            generator.jump();
+            generator.jump();
+
+            submodels_endpoints.push_back(atomics.sender);
+            submodels_endpoints.push_back(atomics.receiver);
+            submodels_endpoints.push_back(endpoints_side);
+            eocs_endpoints.push_back(cadmium::dynamic::translate::make_EOC<sender_defs::packetSentOut,
+                                                                           outp_pack>(sender_id));
+            eocs_endpoints.push_back(cadmium::dynamic::translate::make_EOC<sender_defs::ackReceivedOut,
+                                                                           outp_ack>(sender_id));
+            ics_endpoints.push_back(cadmium::dynamic::translate::make_IC<iestream_input_defs<message_t>::out,
+                                                                         sender_defs::controlIn>("generator_con",
+                                                                                                 sender_id));
+            ics_endpoints.push_back(cadmium::dynamic::translate::make_IC<sender_defs::dataOut,
+                                                                         endpoint_proxy_defs::data_in>(sender_id,
+                                                                                                       endpoint_proxy_id));
+            ics_endpoints.push_back(cadmium::dynamic::translate::make_IC<receiver_defs::out,
+                                                                         endpoint_proxy_defs::ack_in>(receiver_id,
+                                                                                                      endpoint_proxy_id));
+            ics_endpoints.push_back(cadmium::dynamic::translate::make_IC<endpoint_proxy_defs::data_out,
+                                                                         receiver_defs::in>(endpoint_proxy_id,
+                                                                                            receiver_id));
+            ics_endpoints.push_back(cadmium::dynamic::translate::make_IC<endpoint_proxy_defs::ack_out,
+                                                                         sender_defs::ackIn>(endpoint_proxy_id,
+                                                                                             sender_id));
+            model.flows.push_back(atomics);
+        }
+    }
+
+    cadmium::dynamic::modeling::Ports oports_endpoints = {
+        typeid(outp_pack),
+        typeid(outp_ack)
+    };
+    model.endpoints =
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>("Endpoints",
+                                                                submodels_endpoints,
+                                                                cadmium::dynamic::modeling::Ports{},
+                                                                oports_endpoints,
+                                                                cadmium::dynamic::modeling::EICs{},
+                                                                eocs_endpoints,
+                                                                ics_endpoints
+                                                                );
+    return model;
+}
+
+/**
+ * Thread running the network process, kept for the whole run. Each
+ * window is started by the thread of the endpoints, which waits for
+ * its end before the processes exchange their messages.
+ */
+template<typename TIME>
+class network_thread{
+    public:
+    /**
+     * Starts the thread, which waits for the first window
+     * @param network the network process
+     */
+    explicit network_thread(network_process<TIME> &network) :
+        network(network), started(0), finished(0), stopping(false),
+        thread(&network_thread::run, this) {}
+
+    network_thread(const network_thread &) = delete;
+    network_thread &operator=(const network_thread &) = delete;
+
+    /**
+     * Stops and joins the thread, after the window it runs if any
+     */
+    ~network_thread(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_one();
+        thread.join();
+    }
+
+    /**
+     * Starts running the network until the given time
+     * @param until end of the window
+     */
+    void start_window(const TIME &until){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            window_end = until;
+            started++;
+        }
+        start.notify_one();
+    }
+
+    /**
+     * Waits for the end of the window started last
+     */
+    void wait_window(){
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]{ return finished == started; });
+    }
+
+    private:
+    network_process<TIME> &network;
+    std::mutex mutex;              ///< Guards the fields below
+    std::condition_variable start; ///< Notified when a window starts or the thread stops
+    std::condition_variable done;  ///< Notified when a window ends
+    TIME window_end;               ///< End of the window started last
+    uint64_t started;              ///< Number of windows started
+    uint64_t finished;             ///< Number of windows run
+    bool stopping;                 ///< The run is over
+    std::thread thread;            ///< Started last, once the fields above are set
+
+    /**
+     * Body of the thread: runs every window until it is stopped
+     */
+    void run(){
+        for (;;){
+            TIME until;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start.wait(lock, [this]{ return stopping || started != finished; });
+                if (stopping){
+                    return;
+                }
+                until = window_end;
+            }
+            network.run_until(until);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished++;
+            }
+            done.notify_one();
+        }
+    }
+};
+
+/**
+ * Runs the two logical processes until the given time, each one on
+ * its own thread, a window at a time. The endpoints may run a
+ * lookahead ahead of the network, and half a lookahead past their
+ * next event so both processes have work in each window; the network
+ * runs up to the next event of the endpoints.
+ * @param model logical processes built by make_abp_conservative_model
+ * @param until time the simulation is ran until
+ * @return number of windows run
+ */
+template<typename TIME>
+uint64_t run_abp_conservative(abp_conservative_model<TIME> &model, const TIME &until){
+    using runner = cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger>;
+    abp_link<TIME> &link = *model.link;
+    const TIME infinity = std::numeric_limits<TIME>::infinity();
+    const TIME half_lookahead = seconds_to_time<TIME>(time_to_seconds(link.lookahead) / 2);
+    runner endpoints(model.endpoints, TIME());
+    network_process<TIME> &network = *model.network;
+    TIME endpoints_time = TIME();
+    TIME network_time = TIME();
+    TIME endpoints_next = endpoints.run_until(TIME());
+    network_thread<TIME> network_lp(network);
+    uint64_t windows = 0;
+    while (endpoints_time < until || network_time < until){
+        // deliveries not known yet are at least a lookahead after the network time
+        TIME endpoints_until = std::min(network_time + link.lookahead, until);
+        if (endpoints_next != infinity){
+            endpoints_until = std::min(endpoints_until, endpoints_next + half_lookahead);
+        } else if (network.idle()){
+            // nothing left to send to the endpoints or by them
+            endpoints_until = until;
+        }
+        endpoints_until = std::max(endpoints_until, endpoints_time);
+        TIME network_until = std::min(endpoints_next, endpoints_until);
+        network_until = std::max(std::min(network_until, until), network_time);
+
+        link.network_time = network_time;
+        network_lp.start_window(network_until);
+        endpoints_next = endpoints.run_until(endpoints_until);
+        network_lp.wait_window();
+        endpoints_time = endpoints_until;
+        network_time = network_until;
+        windows++;
+
+        for (const abp_link_message<TIME> &message : link.to_network){
+            network.deliver(message);
+        }
+        for (const abp_link_message<TIME> &message : link.to_endpoints){
+            model.endpoint_proxies[message.flow]->deliver(message);
+        }
+        link.to_network.clear();
+        link.to_endpoints.clear();
+    }
+    return windows;
+}
+
+#endif // __ABP_CONSERVATIVE_HPP__
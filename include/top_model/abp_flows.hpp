@@ -0,0 +1,204 @@
+/** \brief This header file builds the multi-flow top model of the ABP Simulator.
+ *
+ * The multi-flow top model runs many independent ABP flows side by
+ * side: each flow is the ABPSimulator coupled model of a sender and a
+ * receiver over their own network, as in the single flow top model,
+ * and one control generator fans its input out to the sender of
+ * every flow. The flows are given by a count, or by a flows file of
+ * groups of flows sharing the parameters of their atomic models.
+ *
+ * A flow holds nothing but its models, so the memory of the model
+ * grows with the number of flows only through the atomic models
+ * themselves, which is reported by the driver.
+ */
+
+#ifndef __ABP_FLOWS_HPP__
+#define __ABP_FLOWS_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abp_top_model.hpp"
+#include "abp_sweep.hpp"
+
+/**
+ * Group of flows whose atomic models have the same parameters
+ */
+struct abp_flow_group{
+    uint64_t flows;             /**< Number of flows of the group */
+    abp_sweep_point parameters; /**< Parameters of their atomic models, times in seconds */
+};
+
+/**
+ * Reads the groups of flows from a flows file. Each line is the
+ * number of flows of a group followed by the names and the values
+ * of the parameters that are not the default ones, times in
+ * seconds. Lines starting with # are comments.
+ * @param file path of the flows file
+ * @param defaults default value of each parameter
+ * @param groups groups of flows read
+ * @return false if the file cannot be read or is not valid
+ */
+bool read_flow_groups(const char *file,
+                      const abp_sweep_point &defaults,
+                      std::vector<abp_flow_group> &groups);
+
+/**
+ * @return resident memory of the process in bytes, 0 if it is not known
+ */
+size_t resident_memory();
+
+/**
+ * Structure that holds the TOP coupled model of many flows given
+ * to the runner together with the flows.
+ */
+template<typename TIME>
+struct abp_flows_model{
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> top;
+    std::vector<abp_flow<TIME>> flows;
+};
+
+/**
+ * Builds TOP -> ABPSimulator<n> -> Network for every flow of the
+ * groups, numbered from 1 in the order of the groups, the control
+ * generator feeding all of them. The subnets of flow n draw from the
+ * streams 2 (n - 1) and 2 (n - 1) + 1 of the seed, as in make_abp_flow.
+ * Only the flows from first to first + count - 1 may be built, with
+ * a generator of their own, as a partition of the whole model.
+ * @param input_file path of the input file of the control generator
+ * @param groups groups of flows
+ * @param seed seed of the random generators of the subnets
+ * @param profile true to time the functions of the atomic models
+ * @param first number of the first flow built
+ * @param count number of flows built, all the following ones by default
+ * @return the top model and its flows
+ */
+template<typename TIME>
+abp_flows_model<TIME> make_abp_flows_model(const char *input_file,
+                                           const std::vector<abp_flow_group> &groups,
+                                           uint64_t seed = DEFAULT_RANDOM_SEED,
+                                           bool profile = false,
+                                           uint64_t first = 1,
+                                           uint64_t count = UINT64_MAX){
+    abp_flows_model<TIME> model;
+    uint64_t total = 0;
+    for (const abp_flow_group &group : groups){
+        total += group.flows;
+    }
+    count = first > total ? 0 : std::min(count, total - first + 1);
+
+    /**
+     * Initialized generator which has output file path, Time and
+     * with given input generates the output
+     */
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator_con =
+                    make_abp_atomic_model
+                    <ApplicationGen,
+                     TIME,
+                     const char* >(profile,
+                                   false,
+                                   "generator_con" ,
+                                   std::move(input_file)
+                                   );
+
+    /**
+     * TOP coupled model made of the control generator and the
+     * ABP simulator of every flow, all fed by the generator
+     */
+    cadmium::dynamic::modeling::Ports iports_TOP = {};
+    cadmium::dynamic::modeling::Ports oports_TOP = {
+        typeid(outp_pack),
+        typeid(outp_ack)
+    };
+    cadmium::dynamic::modeling::Models submodels_TOP = {
+        generator_con
+    };
+    cadmium::dynamic::modeling::EICs eics_TOP = {};
+    cadmium::dynamic::modeling::EOCs eocs_TOP;
+    cadmium::dynamic::modeling::ICs ics_TOP;
+    random_generator generator(seed, 0);
+    for (uint64_t flow = 1; flow < first; flow++){
+        generator.jump();
+        generator.jump();
+    }
+    model.flows.reserve(count);
+    submodels_TOP.reserve(count + 1);
+    eocs_TOP.reserve(2 * count);
+    ics_TOP.reserve(count);
+
+    uint64_t group_first = 1;
+    for (const abp_flow_group &group : groups){
+        uint64_t begin = std::max(first, group_first);
+        uint64_t end = std::min(first + count, group_first + group.flows);
+        group_first += group.flows;
+        if (begin >= end){
+            continue;
+        }
+        abp_parameters<TIME> parameters = to_parameters<TIME>(group.parameters);
+        for (uint64_t flow = begin; flow < end; flow++){
+            std::string id = "ABPSimulator" + std::to_string(flow);
+            model.flows.push_back(make_abp_flow<TIME>(flow, id, generator, parameters, profile));
+            // the subnets of the next flow draw from the next two streams
+            generator.jump();
+            generator.jump();
+            submodels_TOP.push_back(model.flows.back().simulator);
+            eocs_TOP.push_back(cadmium::dynamic::translate::make_EOC<outp_pack,
+                                                                     outp_pack>(id));
+            eocs_TOP.push_back(cadmium::dynamic::translate::make_EOC<outp_ack,
+                                                                     outp_ack>(id));
+            ics_TOP.push_back(cadmium::dynamic::translate::make_IC<iestream_input_defs<message_t>::out,
+                                                                   inp_control>("generator_con",
+                                                                                id));
+        }
+    }
+
+    model.top =
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>( "TOP",
+                                                                submodels_TOP,
+                                                                iports_TOP,
+                                                                oports_TOP,
+                                                                eics_TOP,
+                                                                eocs_TOP,
+                                                                ics_TOP
+                                                                );
+    return model;
+}
+
+/**
+ * Reads the aggregate results of a finished run of many flows: the
+ * sums of the counts of the flows, their merged histograms and the
+ * time of the last acknowledged packet of any flow.
+ * @param model top model built by make_abp_flows_model
+ * @param end_time time the simulation ended, given by the runner
+ * @return the results of the run
+ */
+template<typename TIME>
+abp_results<TIME> collect_abp_flows_results(const abp_flows_model<TIME> &model, 
+                                            const TIME &end_time){
+    abp_results<TIME> results;
+    results.packets_delivered = 0;
+    results.retransmissions = 0;
+    results.packets_lost = 0;
+    results.last_delivery_time = TIME();
+    results.end_time = end_time;
+    for (const abp_flow<TIME> &flow : model.flows){
+        abp_results<TIME> flow_results = collect_abp_results(flow, end_time);
+        results.packets_delivered += flow_results.packets_delivered;
+        results.packets_sent += flow_results.packets_sent;
+        results.retransmissions += flow_results.retransmissions;
+        results.packets_received += flow_results.packets_received;
+        results.duplicates += flow_results.duplicates;
+        results.packets_lost += flow_results.packets_lost;
+        results.packets_dropped += flow_results.packets_dropped;
+        results.last_delivery_time = std::max(results.last_delivery_time, flow_results.last_delivery_time);
+        results.latency.merge(flow_results.latency);
+        results.packet_retransmissions.merge(flow_results.packet_retransmissions);
+        results.queue_depth.merge(flow_results.queue_depth);
+    }
+    return results;
+}
+
+#endif // __ABP_FLOWS_HPP__
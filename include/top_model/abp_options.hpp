@@ -0,0 +1,158 @@
+/** \brief This header file declares the command line options of the ABP Simulator.
+ *
+ * The options are shared by the executables that run the ABP
+ * Simulator top model.
+ */
+
+#ifndef __ABP_OPTIONS_HPP__
+#define __ABP_OPTIONS_HPP__
+
+#include <cstdint>
+
+#include "../random/random_generator.hpp"
+
+/**
+ * Command line options of the ABP Simulator
+ */
+struct abp_options{
+    const char *input_file = nullptr; /**< Input data control file */
+    bool trace = true;                /**< Write the simulation log */
+    bool raw_trace = true;            /**< Write the log besides its table */
+    bool binary_trace = false;        /**< Write the log as a binary trace instead */
+    bool profile = false;             /**< Time the functions of the atomic models */
+    uint64_t seed = DEFAULT_RANDOM_SEED; /**< Seed of the random generators of the subnets */
+    bool seeded = false;              /**< The seed was given, restored subnets are reseeded */
+    bool until_quiescent = false;     /**< Run until every model is passive, without a time limit */
+    uint64_t until_delivered = 0;     /**< Stop once the sender delivered these packets, 0 for no limit */
+    uint64_t wall_clock = 0;          /**< Stop after these seconds of wall time, 0 for no limit */
+    const char *checkpoint_file = nullptr; /**< Checkpoint the run is saved to */
+    uint64_t checkpoint_interval = 0; /**< Simulated seconds between checkpoints, 0 to only save at the stop */
+    const char *restore_file = nullptr; /**< Checkpoint the run is resumed from */
+    uint64_t window = 0;              /**< Window of the sender, 0 for the alternating bit protocol */
+    bool selective_repeat = false;    /**< The window is Selective Repeat instead of Go-Back-N */
+    bool adaptive_timeout = false;    /**< The sender estimates its timeout from the round trip times */
+    const char *parameters_file = nullptr; /**< Parameters of the atomic models that are not the default ones */
+    const char *delay_file = nullptr; /**< Samples of the empirical delay of the subnets */
+    const char *stats_file = nullptr; /**< Summary of the statistics of the run, JSON or CSV */
+};
+
+/**
+ * Parses the command line: the input file followed by optional flags.
+ *      --no-trace    run with a null logger and only report the results
+ *      --table-only  write the transformed table but not the log itself
+ *      --binary-trace write the log as a binary trace instead of the text files
+ *      --seed N      seed of the random generators of the subnets
+ *      --profile     time the functions of the atomic models and report them
+ *      --until-quiescent run until every model is passive instead of 04:00:00:000
+ *      --until-delivered N stop once the sender delivered N packets
+ *      --wall-clock N stop after N seconds of wall time
+ *      --checkpoint FILE save the run to FILE when it stops
+ *      --checkpoint-interval N also save it every N seconds of simulated time
+ *      --restore FILE resume the run saved to FILE, with the same input
+ *                    file; with --seed the subnets are reseeded at it
+ *      --window N    send up to N packets ahead of their acknowledgements,
+ *                    Go-Back-N, instead of the alternating bit protocol
+ *      --selective-repeat make the window Selective Repeat
+ *      --adaptive-timeout estimate the timeout of the sender from the
+ *                    round trip times instead of waiting a constant time
+ *      --parameters FILE parameters of the atomic models, as in the flows files
+ *      --delay-file FILE draw the delays of the subnets from the samples in FILE
+ *      --stats FILE  write the statistics of the run to FILE, as CSV if
+ *                    its name ends in .csv and as JSON otherwise
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param options options filled from the command line
+ * @return false if the command line is not valid
+ */
+bool parse_options(int argc, char ** argv, abp_options &options);
+
+/**
+ * Command line options of the replication driver
+ */
+struct abp_replication_options{
+    const char *input_file = nullptr;    /**< Input data control file */
+    uint64_t seed = DEFAULT_RANDOM_SEED; /**< Seed of the first replication */
+    uint64_t runs = 100;                 /**< Number of replications */
+    uint64_t threads = 0;                /**< Worker threads, 0 for one per core */
+};
+
+/**
+ * Parses the command line of the replication driver: the input
+ * file followed by optional flags.
+ *      --runs N      number of replications
+ *      --threads N   number of worker threads
+ *      --seed N      seed of the first replication
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param options options filled from the command line
+ * @return false if the command line is not valid
+ */
+bool parse_replication_options(int argc, char ** argv, 
+                               abp_replication_options &options);
+
+/**
+ * Command line options of the parameter sweep
+ */
+struct abp_sweep_options{
+    const char *input_file = nullptr;    /**< Input data control file */
+    const char *grid_file = nullptr;     /**< Values or ranges of the parameters */
+    const char *output_file = "data/top_model/abp_sweep_output.csv"; /**< Results, a row per point */
+    uint64_t lhs = 0;                    /**< Latin hypercube points, 0 for the grid */
+    uint64_t seed = DEFAULT_RANDOM_SEED; /**< Seed of the sweep */
+    uint64_t runs = 10;                  /**< Replications of each point */
+    uint64_t threads = 0;                /**< Worker threads, 0 for one per core */
+};
+
+/**
+ * Parses the command line of the parameter sweep: the input
+ * file followed by the grid file and optional flags.
+ *      --grid FILE   values of the parameters, or their ranges with --lhs
+ *      --lhs N       sample N points of the ranges instead of the grid
+ *      --output FILE file the results are written to
+ *      --runs N      replications of each point
+ *      --threads N   number of worker threads
+ *      --seed N      seed of the sweep
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param options options filled from the command line
+ * @return false if the command line is not valid
+ */
+bool parse_sweep_options(int argc, char ** argv, abp_sweep_options &options);
+
+
+/**
+ * Command line options of the multi-flow simulator
+ */
+struct abp_flow_options{
+    const char *input_file = nullptr; /**< Input data control file, fanned out to every flow */
+    const char *flows_file = nullptr; /**< Groups of flows and their parameters */
+    uint64_t flows = 1;               /**< Number of flows when there is no flows file */
+    bool trace = true;                /**< Write the simulation log */
+    bool raw_trace = true;            /**< Write the log besides its table */
+    uint64_t seed = DEFAULT_RANDOM_SEED; /**< Seed of the random generators of the subnets */
+    uint64_t threads = 1;             /**< Worker threads, the flows are partitioned with more than one */
+    uint64_t sync_interval = 60;      /**< Seconds of simulated time between synchronizations of the partitions */
+    bool conservative = false;        /**< Run the endpoints and the network as two logical processes */
+};
+
+/**
+ * Parses the command line of the multi-flow simulator: the input
+ * file followed by optional flags.
+ *      --flows N     number of flows with the default parameters
+ *      --config FILE groups of flows and their parameters, instead of --flows
+ *      --no-trace    run with a null logger and only report the results
+ *      --table-only  write the transformed table but not the log itself
+ *      --seed N      seed of the random generators of the subnets
+ *      --threads N   run the flows in N partitions on N worker threads
+ *      --sync-interval N seconds of simulated time between synchronizations
+ *      --conservative run the endpoints and the network of the flows as two
+ *                    logical processes on two threads, without a log
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param options options filled from the command line
+ * @return false if the command line is not valid
+ */
+bool parse_flow_options(int argc, char ** argv, abp_flow_options &options);
+
+
+#endif // __ABP_OPTIONS_HPP__
@@ -0,0 +1,53 @@
+/** \brief This header file defines the ports of the ABP Simulator coupled models.
+ *
+ * The ports of the Network, ABPSimulator and TOP coupled models and
+ * the application generator are shared by the dynamic and the static
+ * builds of the ABP Simulator top model.
+ */
+
+#ifndef __ABP_PORTS_HPP__
+#define __ABP_PORTS_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+
+#include "../../lib/vendor/iestream.hpp"
+
+#include "../data_structures/message.hpp"
+
+/**
+ * Setting input ports for messages
+ */
+struct inp_control : public cadmium::in_port<message_t> {};
+struct inp_1 : public cadmium::in_port<message_t> {};
+struct inp_2 : public cadmium::in_port<message_t> {};
+
+/**
+ * Setting output ports for messages 
+ */
+struct outp_ack : public cadmium::out_port<message_t> {};
+struct outp_1 : public cadmium::out_port<message_t> {};
+struct outp_2 : public cadmium::out_port<message_t> {};
+struct outp_pack : public cadmium::out_port<message_t> {};
+
+
+/**
+ * This is application generator class takes file path
+ * parameter and waits for input
+ * @tParam message T
+ */
+template<typename T>
+class ApplicationGen : public iestream_input<message_t,T>{
+    public:
+    ApplicationGen() = default;
+    /**
+     * A parameterized contructor for class application generator 
+     * takes input path of the file that containes the input for
+     * the application to run
+     * @param file_path
+     */
+    ApplicationGen(const char* file_path) : 
+        iestream_input<message_t,T>(file_path) {}
+};
+
+
+#endif // __ABP_PORTS_HPP__
@@ -0,0 +1,121 @@
+/** \brief This header file implements the replication driver of the ABP Simulator.
+ *
+ * The loss in the subnets is random, so a configuration is
+ * characterized by many independent runs. The replications are
+ * spread over a pool of threads; each one builds its own top model
+ * with its own seed and runs it with a null logger, so the threads
+ * share nothing but the index of the next replication.
+ */
+
+#ifndef __ABP_REPLICATIONS_HPP__
+#define __ABP_REPLICATIONS_HPP__
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../data_structures/time_conversion.hpp"
+#include "abp_top_model.hpp"
+
+/**
+ * Mean of a sample and the half width of its confidence interval
+ */
+struct confidence_interval{
+    double mean;       /**< Mean of the sample */
+    double half_width; /**< The interval is mean +- half_width */
+};
+
+/**
+ * Computes the 95% confidence interval of the mean of a sample
+ * with the Student t distribution.
+ * @param sample values measured in each replication
+ * @return mean and half width, 0 when there is a single value
+ */
+confidence_interval mean_confidence_interval(const std::vector<double> &sample);
+
+/**
+ * Converts a simulation time to seconds
+ * @param time simulation time
+ * @return seconds
+ */
+template<typename TIME>
+double time_to_seconds(const TIME &time){
+    return time_to_milliseconds(time) / 1000.0;
+}
+
+/**
+ * Converts seconds to a simulation time, rounded to the millisecond
+ * @param seconds seconds, not negative
+ * @return simulation time
+ */
+template<typename TIME>
+TIME seconds_to_time(double seconds){
+    return time_from_milliseconds<TIME>(std::llround(seconds * 1000));
+}
+
+/**
+ * Builds the top model and runs one replication with a null logger
+ * @param input_file input data control file
+ * @param seed seed of the subnets
+ * @param parameters parameters of the atomic models
+ * @param until time the replication is ran until
+ * @return the results of the replication
+ */
+template<typename TIME>
+abp_results<TIME> run_replication(const char *input_file, 
+                                  uint64_t seed, 
+                                  const abp_parameters<TIME> &parameters, 
+                                  const TIME &until){
+    abp_top_model<TIME> model = make_abp_top_model<TIME>(input_file, 
+                                                         seed, 
+                                                         parameters);
+    cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger> 
+        r(model.top, {0});
+    r.run_until(until);
+    return collect_abp_results(model, until);
+}
+
+/**
+ * Runs independent replications of the ABP Simulator on a pool
+ * of threads. Replication i seeds its subnets with seed + i, so the
+ * results do not depend on the number of threads.
+ * @param input_file input data control file
+ * @param runs number of replications
+ * @param threads number of worker threads
+ * @param seed seed of the first replication
+ * @param parameters parameters of the atomic models
+ * @param until time the replications are ran until
+ * @return the results of each replication, in order
+ */
+template<typename TIME>
+std::vector<abp_results<TIME>> run_replications(const char *input_file, 
+                                                uint64_t runs, 
+                                                unsigned int threads, 
+                                                uint64_t seed, 
+                                                const abp_parameters<TIME> &parameters, 
+                                                const TIME &until){
+    std::vector<abp_results<TIME>> results(runs);
+    std::atomic<uint64_t> next(0);
+
+    auto worker = [&](){
+        for (uint64_t i = next++; i < runs; i = next++){
+            results[i] = run_replication(input_file, seed + i, parameters, until);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; t++){
+        pool.emplace_back(worker);
+    }
+    for (std::thread &t : pool){
+        t.join();
+    }
+    return results;
+}
+
+#endif // __ABP_REPLICATIONS_HPP__
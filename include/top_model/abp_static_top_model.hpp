@@ -0,0 +1,163 @@
+/** \brief This header file defines the ABP Simulator top model as static coupled models.
+ *
+ * Same topology as make_abp_top_model, TOP -> ABPSimulator -> Network,
+ * but every coupled model is a type built at compile time with
+ * cadmium::modeling::coupled_model, so the static engine routes the
+ * messages without virtual calls or type erased couplings.
+ *
+ * Static models are identified by their type, so each instance of
+ * the atomic models is a class of its own named after the model
+ * it stands for in the dynamic build.
+ */
+
+#ifndef __ABP_STATIC_TOP_MODEL_HPP__
+#define __ABP_STATIC_TOP_MODEL_HPP__
+
+#include <tuple>
+#include <cstdint>
+
+#include <cadmium/modeling/coupled_model.hpp>
+#include <cadmium/modeling/ports.hpp>
+
+#include "../atomics/sender_cadmium.hpp"
+#include "../atomics/receiver_cadmium.hpp"
+#include "../atomics/subnet_cadmium.hpp"
+
+#include "abp_ports.hpp"
+
+/**
+ * Input file read by the static control generator. Static models
+ * are built with their default constructor, so it must be set
+ * before the runner is created.
+ * @return reference to the input file path
+ */
+inline const char*& abp_static_input_file(){
+    static const char *input_file = nullptr;
+    return input_file;
+}
+
+/**
+ * Seed of the random generators of the static subnets. It must be
+ * set before the runner is created, like abp_static_input_file.
+ * @return reference to the seed
+ */
+inline uint64_t& abp_static_seed(){
+    static uint64_t seed = DEFAULT_RANDOM_SEED;
+    return seed;
+}
+
+/**
+ * Control generator reading the file set in abp_static_input_file
+ */
+template<typename TIME>
+class generator_con : public ApplicationGen<TIME>{
+    public:
+    generator_con() : ApplicationGen<TIME>(abp_static_input_file()) {}
+};
+
+/**
+ * Atomic models of the ABP Simulator
+ */
+template<typename TIME>
+class sender1 : public Sender<TIME>{};
+template<typename TIME>
+class receiver1 : public Receiver<TIME>{};
+template<typename TIME>
+class subnet1 : public Subnet<TIME>{
+    public:
+    subnet1() : Subnet<TIME>(abp_static_seed(), 0) {}
+};
+template<typename TIME>
+class subnet2 : public Subnet<TIME>{
+    public:
+    subnet2() : Subnet<TIME>(abp_static_seed(), 1) {}
+};
+
+/**
+ * Network coupled model made of the two subnets
+ */
+using iports_Network = std::tuple<inp_1, inp_2>;
+using oports_Network = std::tuple<outp_1, outp_2>;
+using submodels_Network = cadmium::modeling::models_tuple<subnet1, subnet2>;
+using eics_Network = std::tuple<
+    cadmium::modeling::EIC<inp_1, subnet1, subnet_defs::in>,
+    cadmium::modeling::EIC<inp_2, subnet2, subnet_defs::in>
+>;
+using eocs_Network = std::tuple<
+    cadmium::modeling::EOC<subnet1, subnet_defs::out, outp_1>,
+    cadmium::modeling::EOC<subnet2, subnet_defs::out, outp_2>
+>;
+using ics_Network = std::tuple<>;
+
+template<typename TIME>
+using Network = cadmium::modeling::coupled_model<TIME, 
+                                                 iports_Network, 
+                                                 oports_Network, 
+                                                 submodels_Network, 
+                                                 eics_Network, 
+                                                 eocs_Network, 
+                                                 ics_Network>;
+
+/**
+ * ABP simulator coupled model made of the sender, the receiver
+ * and the network
+ */
+using iports_ABPSimulator = std::tuple<inp_control>;
+using oports_ABPSimulator = std::tuple<outp_ack, outp_pack>;
+using submodels_ABPSimulator = cadmium::modeling::models_tuple<sender1, 
+                                                               receiver1, 
+                                                               Network>;
+using eics_ABPSimulator = std::tuple<
+    cadmium::modeling::EIC<inp_control, sender1, sender_defs::controlIn>
+>;
+using eocs_ABPSimulator = std::tuple<
+    cadmium::modeling::EOC<sender1, sender_defs::packetSentOut, outp_pack>,
+    cadmium::modeling::EOC<sender1, sender_defs::ackReceivedOut, outp_ack>
+>;
+using ics_ABPSimulator = std::tuple<
+    cadmium::modeling::IC<sender1, sender_defs::dataOut, Network, inp_1>,
+    cadmium::modeling::IC<Network, outp_2, sender1, sender_defs::ackIn>,
+    cadmium::modeling::IC<receiver1, receiver_defs::out, Network, inp_2>,
+    cadmium::modeling::IC<Network, outp_1, receiver1, receiver_defs::in>
+>;
+
+template<typename TIME>
+using ABPSimulator = cadmium::modeling::coupled_model<TIME, 
+                                                      iports_ABPSimulator, 
+                                                      oports_ABPSimulator, 
+                                                      submodels_ABPSimulator, 
+                                                      eics_ABPSimulator, 
+                                                      eocs_ABPSimulator, 
+                                                      ics_ABPSimulator>;
+
+/**
+ * TOP coupled model made of the control generator and
+ * the ABP simulator
+ */
+using iports_TOP = std::tuple<>;
+using oports_TOP = std::tuple<outp_pack, outp_ack>;
+using submodels_TOP = cadmium::modeling::models_tuple<generator_con, 
+                                                      ABPSimulator>;
+using eics_TOP = std::tuple<>;
+using eocs_TOP = std::tuple<
+    cadmium::modeling::EOC<ABPSimulator, outp_pack, outp_pack>,
+    cadmium::modeling::EOC<ABPSimulator, outp_ack, outp_ack>
+>;
+using ics_TOP = std::tuple<
+    cadmium::modeling::IC<generator_con, 
+                          iestream_input_defs<message_t>::out, 
+                          ABPSimulator, 
+                          inp_control>
+>;
+
+template<typename TIME>
+using TOP = cadmium::modeling::coupled_model<TIME, 
+                                             iports_TOP, 
+                                             oports_TOP, 
+                                             submodels_TOP, 
+                                             eics_TOP, 
+                                             eocs_TOP, 
+                                             ics_TOP>;
+
+
+#endif // __ABP_STATIC_TOP_MODEL_HPP__
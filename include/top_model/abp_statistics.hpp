@@ -0,0 +1,119 @@
+/** \brief This header file implements the statistics summary of a run of the ABP Simulator.
+ *
+ * The atomic models count what they do while they run: the sender
+ * the packets it sends, sends again and delivers, the receiver the
+ * packets it receives and the duplicates among them, and the subnets
+ * the packets they lose or drop. The counts are read from their
+ * states once the run stops and written as a single summary, a JSON
+ * object, or a CSV header and row when the file name ends in .csv,
+ * so a run without a log still gives its statistics, and no log has
+ * to be parsed to get them.
+ */
+
+#ifndef __ABP_STATISTICS_HPP__
+#define __ABP_STATISTICS_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../data_structures/time_conversion.hpp"
+#include "../metrics/latency_histogram.hpp"
+#include "abp_stop.hpp"
+#include "abp_top_model.hpp"
+
+/**
+ * Field of the summary: its name, its value as written and whether
+ * the value is a text, quoted in JSON
+ */
+struct abp_statistic{
+    std::string name;  ///< Name of the field
+    std::string value; ///< Value as written
+    bool text;         ///< The value is a text, not a number
+};
+
+/**
+ * Lists the fields of the summary of a run, in the order they are written
+ * @param results results returned by collect_abp_results
+ * @param reason reason the run stopped
+ * @return the fields
+ */
+template<typename TIME>
+std::vector<abp_statistic> abp_statistics(const abp_results<TIME> &results,
+                                          abp_stop_reason reason){
+    std::vector<abp_statistic> fields;
+    auto add = [&fields](const char *name, const auto &value, bool text = false){
+        std::ostringstream os;
+        os << value;
+        fields.push_back(abp_statistic{name, os.str(), text});
+    };
+    add("packets_sent", results.packets_sent);
+    add("retransmissions", results.retransmissions);
+    add("packets_delivered", results.packets_delivered);
+    add("packets_received", results.packets_received);
+    add("duplicates", results.duplicates);
+    add("packets_lost", results.packets_lost);
+    add("packets_dropped", results.packets_dropped);
+    add("completion_time_ms", time_to_milliseconds(results.last_delivery_time));
+    add("end_time_ms", time_to_milliseconds(results.end_time));
+    add("latency_mean_ms", results.latency.mean());
+    add("latency_max_ms", results.latency.max());
+    add("stop_reason", stop_reason_name(reason), true);
+    return fields;
+}
+
+/**
+ * Writes the summary of a run
+ * @param os the output stream
+ * @param results results returned by collect_abp_results
+ * @param reason reason the run stopped
+ * @param csv true to write a CSV header and row instead of a JSON object
+ */
+template<typename TIME>
+void write_abp_statistics(std::ostream &os, const abp_results<TIME> &results,
+                          abp_stop_reason reason, bool csv){
+    std::vector<abp_statistic> fields = abp_statistics(results, reason);
+    if (csv){
+        for (size_t i = 0; i < fields.size(); i++){
+            os << (i ? "," : "") << fields[i].name;
+        }
+        os << '\n';
+        for (size_t i = 0; i < fields.size(); i++){
+            os << (i ? "," : "") << fields[i].value;
+        }
+        os << '\n';
+        return;
+    }
+    os << "{\n";
+    for (size_t i = 0; i < fields.size(); i++){
+        const char *quote = fields[i].text ? "\"" : "";
+        os << "  \"" << fields[i].name << "\": " << quote << fields[i].value << quote
+           << (i + 1 < fields.size() ? ",\n" : "\n");
+    }
+    os << "}\n";
+}
+
+/**
+ * Writes the summary of a run to a file, as CSV if its name ends in
+ * .csv and as JSON otherwise
+ * @param file path of the summary
+ * @param results results returned by collect_abp_results
+ * @param reason reason the run stopped
+ * @return false if the file cannot be written
+ */
+template<typename TIME>
+bool write_abp_statistics(const char *file, const abp_results<TIME> &results,
+                          abp_stop_reason reason){
+    size_t length = strlen(file);
+    bool csv = length >= 4 && strcmp(file + length - 4, ".csv") == 0;
+    std::ofstream os(file);
+    write_abp_statistics(os, results, reason, csv);
+    os.close();
+    return !os.fail();
+}
+
+#endif // __ABP_STATISTICS_HPP__
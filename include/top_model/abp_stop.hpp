@@ -0,0 +1,144 @@
+/** \brief This header file implements the stop conditions of a run of the ABP Simulator.
+ *
+ * By default a run stops at a fixed simulated time. Without a time
+ * limit it stops as soon as every model is passive, the generator
+ * exhausted included. It may also stop once the sender has delivered
+ * a number of packets, or once a budget of wall time is spent. With
+ * these conditions, or without a time limit, the runner is driven an
+ * event time at a time, so they are checked between events; with
+ * none of them it runs up to the time limit at once, or a checkpoint
+ * interval at a time when the run is checkpointed.
+ * The reason the run stopped is returned to be reported, with the
+ * time the run was run until, at which it can be saved.
+ */
+
+#ifndef __ABP_STOP_HPP__
+#define __ABP_STOP_HPP__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+
+#include <cadmium/modeling/dynamic_coupled.hpp>
+
+#include "../atomics/sender_cadmium.hpp"
+#include "../atomics/window_sender_cadmium.hpp"
+
+/**
+ * Reasons a run stops
+ */
+enum abp_stop_reason{
+    STOP_TIME_LIMIT, ///< The simulated time limit was reached
+    STOP_QUIESCENT,  ///< Every model is passive, without a time limit
+    STOP_DELIVERED,  ///< The sender delivered the packets asked
+    STOP_WALL_CLOCK  ///< The wall time budget was spent
+};
+
+/**
+ * Conditions stopping a run, the first one met stops it
+ */
+template<typename TIME>
+struct abp_stop_conditions{
+    TIME until = TIME("04:00:00:000"); /**< Simulated time limit, infinity for none */
+    int64_t packets_delivered = 0;     /**< Packets delivered by the sender, 0 for no limit */
+    double wall_clock = 0;             /**< Seconds of wall time, 0 for no limit */
+};
+
+/**
+ * @param reason reason a run stopped
+ * @return the reason as it is reported
+ */
+inline const char *stop_reason_name(abp_stop_reason reason){
+    switch (reason){
+        case STOP_QUIESCENT:
+            return "quiescent";
+        case STOP_DELIVERED:
+            return "packets delivered";
+        case STOP_WALL_CLOCK:
+            return "wall clock";
+        default:
+            return "time limit";
+    }
+}
+
+/**
+ * Runs a runner until one of the conditions is met. A finite time
+ * limit is checked before quiescence: a run with nothing left to
+ * simulate before its limit is run to the limit. With the conditions
+ * checked between events, and without a time limit, the runner is
+ * run an event time at a time, jumping from each event time to the
+ * next one however far it is. The runner only runs the events before
+ * the time it is given and the times of the models are whole
+ * milliseconds, so running it until a millisecond after the next
+ * event time runs all the events of that time and no later one.
+ * The run may be checkpointed as it goes: once at least an interval
+ * of simulated time has passed since the last checkpoint, the
+ * checkpoint function is called between two event times, and the
+ * run is never left idle for longer than an interval before it.
+ * @param runner runner of the top model, not run yet
+ * @param sender alternating bit or window sender whose delivered packets are counted
+ * @param conditions conditions stopping the run
+ * @param time time the runner was created at, set to the time the
+ *             run was run until: the events before it were run, and
+ *             none of the events after it
+ * @param end_time set to the time the simulation ended: the time
+ *                 limit, or the time of the last events run
+ * @param checkpoint function saving the run at the time it is given, or nullptr
+ * @param interval simulated time between two checkpoints
+ * @return the reason the run stopped
+ */
+template<typename TIME, typename RUNNER>
+abp_stop_reason run_until_stopped(RUNNER &runner,
+                                  const std::shared_ptr<cadmium::dynamic::modeling::model> &sender,
+                                  const abp_stop_conditions<TIME> &conditions,
+                                  TIME &time,
+                                  TIME &end_time,
+                                  const std::function<void(const TIME &)> &checkpoint = nullptr,
+                                  const TIME &interval = std::numeric_limits<TIME>::infinity()){
+    const TIME infinity = std::numeric_limits<TIME>::infinity();
+    const TIME resolution({0, 0, 0, 1});
+    const bool stepped = conditions.packets_delivered > 0 || conditions.wall_clock > 0 ||
+                         conditions.until == infinity;
+    const Sender<TIME> *counted = dynamic_cast<const Sender<TIME>*>(sender.get());
+    const WindowSender<TIME> *windowed = dynamic_cast<const WindowSender<TIME>*>(sender.get());
+    auto start = std::chrono::steady_clock::now();
+    TIME saved = time;
+    TIME next = runner.run_until(time);
+    end_time = time;
+    for (;;){
+        if (conditions.packets_delivered > 0 &&
+            (counted ? counted->state.packets_delivered : windowed->state.packets_delivered) >= 
+            conditions.packets_delivered){
+            return STOP_DELIVERED;
+        }
+        if (!(next < conditions.until)){
+            if (conditions.until == infinity){
+                return STOP_QUIESCENT;
+            }
+            time = end_time = conditions.until;
+            return STOP_TIME_LIMIT;
+        }
+        if (conditions.wall_clock > 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >=
+            conditions.wall_clock){
+            return STOP_WALL_CLOCK;
+        }
+        // the next event time alone, or every event up to the limit
+        TIME end = stepped ? next + resolution : conditions.until;
+        if (checkpoint){
+            end = std::min(end, std::max(saved + interval, next + resolution));
+        }
+        time = std::min(end, conditions.until);
+        end_time = next;
+        next = runner.run_until(time);
+        if (checkpoint && !(time < saved + interval)){
+            checkpoint(time);
+            saved = time;
+        }
+    }
+}
+
+#endif // __ABP_STOP_HPP__
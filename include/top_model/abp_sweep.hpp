@@ -0,0 +1,249 @@
+/** \brief This header file implements the parameter sweep of the ABP Simulator.
+ *
+ * A sweep runs the ABP Simulator at many points of the space of
+ * parameters of the atomic models, either every point of a grid or
+ * a Latin hypercube sample of the ranges of the parameters. The
+ * models of each point are built with the parameters given to their
+ * constructors, so no recompilation is needed, and the points are
+ * spread over the cores with work stealing.
+ */
+
+#ifndef __ABP_SWEEP_HPP__
+#define __ABP_SWEEP_HPP__
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "abp_top_model.hpp"
+#include "abp_replications.hpp"
+#include "../parallel/work_stealing.hpp"
+#include "../random/random_generator.hpp"
+
+/**
+ * Parameters swept, in the order of the columns of the results
+ */
+enum abp_parameter_index{
+    SENDER_PREPARATION,
+    SENDER_TIMEOUT,
+    RECEIVER_PREPARATION,
+    PASS_PROBABILITY,
+    DELAY_MEAN,
+    DELAY_STDDEV,
+    DELAY_MIN,
+    WINDOW,
+    WINDOW_SELECTIVE_REPEAT,
+    ADAPTIVE_TIMEOUT,
+    BURST_ENTER,
+    BURST_EXIT,
+    BURST_PASS,
+    DELAY_DISTRIBUTION,
+    DELAY_SHAPE,
+    DELAY_RESOLUTION,
+    QUEUE_CAPACITY,
+    BANDWIDTH,
+    PACKET_SIZE,
+    ABP_PARAMETER_COUNT
+};
+
+/**
+ * Names of the parameters in the grid file and in the results
+ */
+extern const char * const ABP_PARAMETER_NAMES[ABP_PARAMETER_COUNT];
+
+/**
+ * @param i index of a parameter
+ * @param value value of the parameter
+ * @return false if the parameter cannot take the value: times and
+ *         deviations are not negative, probabilities and choices are
+ *         at most 1, and the delay distribution is one of the ones
+ *         that do not need samples
+ */
+bool valid_parameter_value(int i, double value);
+
+/**
+ * Point of the sweep, times in seconds
+ */
+using abp_sweep_point = std::array<double, ABP_PARAMETER_COUNT>;
+
+/**
+ * Values taken by each parameter
+ */
+using abp_sweep_space = std::array<std::vector<double>, ABP_PARAMETER_COUNT>;
+
+/**
+ * Results of the replications of a point of the sweep
+ */
+struct abp_sweep_row{
+    confidence_interval delivery_time; /**< Time of the last delivery in seconds */
+    double retransmissions;            /**< Mean of the retransmissions */
+    double packets_lost;               /**< Mean of the packets lost */
+    double packets_delivered;          /**< Mean of the packets delivered */
+};
+
+/**
+ * Reads the values of the parameters from a grid file. Each line
+ * is the name of a parameter followed by its values, times in
+ * seconds. Lines starting with # are comments. Parameters not in
+ * the file take their default value.
+ * @param file path of the grid file
+ * @param defaults default value of each parameter
+ * @param space values of each parameter read
+ * @return false if the file cannot be read or is not valid
+ */
+bool read_sweep_space(const char *file, 
+                      const abp_sweep_point &defaults, 
+                      abp_sweep_space &space);
+
+/**
+ * Reads the values of some parameters from a parameters file. Each
+ * line holds names of parameters each followed by its value, times
+ * in seconds, as the lines of a flows file without their number of
+ * flows. Lines starting with # are comments.
+ * @param file path of the parameters file
+ * @param point point whose parameters read are set
+ * @return false if the file cannot be read or is not valid
+ */
+bool read_parameter_values(const char *file, abp_sweep_point &point);
+
+/**
+ * Every combination of the values of the parameters
+ * @param space values of each parameter
+ * @return points of the grid
+ */
+std::vector<abp_sweep_point> grid_points(const abp_sweep_space &space);
+
+/**
+ * Latin hypercube sample of the ranges of the parameters. The range
+ * of a parameter goes from its smallest to its largest value. Each
+ * range is split in count strata and every stratum of every
+ * parameter holds exactly one point.
+ * @param space values of each parameter
+ * @param count number of points
+ * @param generator random generator of the sample
+ * @return points of the sample
+ */
+std::vector<abp_sweep_point> latin_hypercube_points(const abp_sweep_space &space, 
+                                                    size_t count, 
+                                                    random_generator &generator);
+
+/**
+ * Writes the points and their results as CSV, one row per point
+ * @param os the output stream
+ * @param points points of the sweep
+ * @param rows results of each point
+ */
+void write_sweep_csv(std::ostream &os, 
+                     const std::vector<abp_sweep_point> &points, 
+                     const std::vector<abp_sweep_row> &rows);
+
+/**
+ * Point of the sweep of the given parameters
+ * @param parameters parameters of the atomic models
+ * @return point, times in seconds
+ */
+template<typename TIME>
+abp_sweep_point to_sweep_point(const abp_parameters<TIME> &parameters){
+    abp_sweep_point point;
+    point[SENDER_PREPARATION] = time_to_seconds(parameters.sender_preparation);
+    point[SENDER_TIMEOUT] = time_to_seconds(parameters.sender_timeout);
+    point[RECEIVER_PREPARATION] = time_to_seconds(parameters.receiver_preparation);
+    point[PASS_PROBABILITY] = parameters.pass_probability;
+    point[DELAY_MEAN] = parameters.delay_mean;
+    point[DELAY_STDDEV] = parameters.delay_stddev;
+    point[DELAY_MIN] = parameters.delay_min;
+    point[WINDOW] = double(parameters.window);
+    point[WINDOW_SELECTIVE_REPEAT] = parameters.mode == SELECTIVE_REPEAT ? 1 : 0;
+    point[ADAPTIVE_TIMEOUT] = parameters.adaptive_timeout ? 1 : 0;
+    point[BURST_ENTER] = parameters.burst_enter;
+    point[BURST_EXIT] = parameters.burst_exit;
+    point[BURST_PASS] = parameters.burst_pass;
+    point[DELAY_DISTRIBUTION] = double(parameters.delay);
+    point[DELAY_SHAPE] = parameters.delay_shape;
+    point[DELAY_RESOLUTION] = double(parameters.delay_resolution);
+    point[QUEUE_CAPACITY] = double(parameters.queue_capacity);
+    point[BANDWIDTH] = parameters.bandwidth;
+    point[PACKET_SIZE] = double(parameters.packet_size);
+    return point;
+}
+
+/**
+ * Parameters of the atomic models at a point of the sweep
+ * @param point point, times in seconds
+ * @return parameters of the atomic models
+ */
+template<typename TIME>
+abp_parameters<TIME> to_parameters(const abp_sweep_point &point){
+    abp_parameters<TIME> parameters;
+    parameters.sender_preparation = seconds_to_time<TIME>(point[SENDER_PREPARATION]);
+    parameters.sender_timeout = seconds_to_time<TIME>(point[SENDER_TIMEOUT]);
+    parameters.receiver_preparation = seconds_to_time<TIME>(point[RECEIVER_PREPARATION]);
+    parameters.pass_probability = point[PASS_PROBABILITY];
+    parameters.delay_mean = point[DELAY_MEAN];
+    parameters.delay_stddev = point[DELAY_STDDEV];
+    parameters.delay_min = point[DELAY_MIN];
+    // sampled windows are rounded to whole packets, and the mode and the timeout to 0 or 1
+    parameters.window = std::max<int64_t>(std::llround(point[WINDOW]), 0);
+    parameters.mode = point[WINDOW_SELECTIVE_REPEAT] >= 0.5 ? SELECTIVE_REPEAT : GO_BACK_N;
+    parameters.adaptive_timeout = point[ADAPTIVE_TIMEOUT] >= 0.5;
+    parameters.burst_enter = point[BURST_ENTER];
+    parameters.burst_exit = point[BURST_EXIT];
+    parameters.burst_pass = point[BURST_PASS];
+    // the distribution and the resolution in milliseconds are rounded as well
+    parameters.delay = delay_distribution(std::llround(point[DELAY_DISTRIBUTION]));
+    parameters.delay_shape = point[DELAY_SHAPE];
+    parameters.delay_resolution = std::max<int64_t>(std::llround(point[DELAY_RESOLUTION]), 1);
+    // the capacity of the queues and the packet size are whole packets and bytes
+    parameters.queue_capacity = std::llround(point[QUEUE_CAPACITY]);
+    parameters.bandwidth = point[BANDWIDTH];
+    parameters.packet_size = std::llround(point[PACKET_SIZE]);
+    return parameters;
+}
+
+/**
+ * Runs the replications of every point of the sweep. Replication r
+ * of point p is seeded with seed + p * runs + r, so the results do
+ * not depend on the number of threads.
+ * @param input_file input data control file
+ * @param points points of the sweep
+ * @param runs replications of each point
+ * @param threads number of worker threads
+ * @param seed seed of the first replication of the first point
+ * @param until time the replications are ran until
+ * @return the results of each point, in order
+ */
+template<typename TIME>
+std::vector<abp_sweep_row> run_sweep(const char *input_file, 
+                                     const std::vector<abp_sweep_point> &points, 
+                                     uint64_t runs, 
+                                     unsigned int threads, 
+                                     uint64_t seed, 
+                                     const TIME &until){
+    std::vector<abp_sweep_row> rows(points.size());
+    parallel_for_work_stealing(points.size(), threads, [&](size_t p){
+        abp_parameters<TIME> parameters = to_parameters<TIME>(points[p]);
+        std::vector<double> delivery_time;
+        abp_sweep_row &row = rows[p];
+        row.retransmissions = row.packets_lost = row.packets_delivered = 0;
+        for (uint64_t r = 0; r < runs; r++){
+            abp_results<TIME> results = run_replication(input_file, 
+                                                        seed + p * runs + r, 
+                                                        parameters, 
+                                                        until);
+            delivery_time.push_back(time_to_seconds(results.last_delivery_time));
+            row.retransmissions += results.retransmissions;
+            row.packets_lost += results.packets_lost;
+            row.packets_delivered += results.packets_delivered;
+        }
+        row.delivery_time = mean_confidence_interval(delivery_time);
+        row.retransmissions /= runs;
+        row.packets_lost /= runs;
+        row.packets_delivered /= runs;
+    });
+    return rows;
+}
+
+#endif // __ABP_SWEEP_HPP__
@@ -0,0 +1,646 @@
+/** \brief This header file builds the ABP Simulator top model.
+ *
+ * Assembles the coupled models of the Alternating Bit Protocol
+ * simulator so that the same topology can be created by the
+ * simulator, the benchmarks and any other driver:
+ *      1- Application Generator
+ *      2- Sender
+ *      3- Receiver
+ *      4- Subnet
+ *      5- Network
+ *
+ * It also collects the aggregate results of a run directly from the
+ * atomic models state, so a run does not need any log output to
+ * report them.
+ */
+
+#ifndef __ABP_TOP_MODEL_HPP__
+#define __ABP_TOP_MODEL_HPP__
+
+#include <memory>
+#include <string>
+
+#include <cadmium/modeling/coupling.hpp>
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/concept/coupled_model_assert.hpp>
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/modeling/dynamic_atomic.hpp>
+
+#include "../../lib/vendor/iestream.hpp"
+
+#include "../data_structures/message.hpp"
+
+#include "../atomics/sender_cadmium.hpp"
+#include "../atomics/receiver_cadmium.hpp"
+#include "../atomics/window_sender_cadmium.hpp"
+#include "../atomics/window_receiver_cadmium.hpp"
+#include "../atomics/subnet_cadmium.hpp"
+#include "../metrics/profiled.hpp"
+#include "../checkpoint/resumable.hpp"
+
+#include "abp_ports.hpp"
+
+/**
+ * Structure that holds the TOP coupled model given to the runner
+ * together with the atomic models whose state is read after the run.
+ */
+template<typename TIME>
+struct abp_top_model{
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> top;
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator;
+    std::shared_ptr<cadmium::dynamic::modeling::model> sender;
+    std::shared_ptr<cadmium::dynamic::modeling::model> receiver;
+    std::shared_ptr<cadmium::dynamic::modeling::model> subnet1;
+    std::shared_ptr<cadmium::dynamic::modeling::model> subnet2;
+};
+
+/**
+ * Parameters of the atomic models. The default values are the
+ * ones of the default constructors of the atomic models.
+ */
+template<typename TIME>
+struct abp_parameters{
+    TIME   sender_preparation = TIME("00:00:10");   /**< Preparation time of the sender */
+    TIME   sender_timeout = TIME("00:00:20");       /**< Timeout of the sender */
+    TIME   receiver_preparation = TIME("00:00:10"); /**< Preparation time of the receiver */
+    double pass_probability = 0.95;                 /**< Probability of a subnet to pass a packet */
+    double delay_mean = 3.0;                        /**< Mean delay of the subnets in seconds */
+    double delay_stddev = 1.0;                      /**< Standard deviation of the delay in seconds */
+    double delay_min = 0.0;                         /**< Minimum delay of the subnets in seconds */
+    int64_t window = 0;                             /**< Packets sent ahead of their acknowledgement, 0 for the alternating bit */
+    window_mode mode = GO_BACK_N;                   /**< Protocol of the window sender and receiver */
+    bool   adaptive_timeout = false;                /**< The senders estimate their timeout from the round trip times */
+    double burst_enter = 0.0;                       /**< Probability of a subnet to enter a burst of losses, 0 for independent losses */
+    double burst_exit = 0.25;                       /**< Probability of a burst of losses to end at each packet */
+    double burst_pass = 0.0;                        /**< Probability of a subnet to pass a packet during a burst */
+    delay_distribution delay = DELAY_NORMAL;        /**< Distribution of the delay of the subnets */
+    double delay_shape = 2.5;                       /**< Shape of the Pareto delay */
+    int64_t delay_resolution = 1000;                /**< Resolution of the delays in milliseconds */
+    std::shared_ptr<const std::vector<double>> delay_samples; /**< Samples of the empirical delay in seconds */
+    int64_t queue_capacity = 0;                     /**< Packets waiting in the queue of a subnet, 0 for no queue */
+    double bandwidth = 0;                           /**< Bytes per second of the link of a subnet, 0 for no transmission time */
+    int64_t packet_size = 1000;                     /**< Bytes of a packet */
+};
+
+/**
+ * Aggregate results of one simulation run.
+ */
+template<typename TIME>
+struct abp_results{
+    int64_t packets_delivered; /**< Packets acknowledged to the sender */
+    int64_t packets_sent = 0;  /**< Packets sent by the sender, the retransmissions included */
+    int64_t retransmissions;   /**< Packets sent again after a timeout */
+    int64_t packets_received = 0; /**< Packets received by the receiver, without the duplicates */
+    int64_t duplicates = 0;    /**< Packets received again by the receiver */
+    int64_t packets_lost;      /**< Packets and acknowledgements dropped by the subnets */
+    int64_t packets_dropped = 0; /**< Packets and acknowledgements dropped by the full queues of the subnets */
+    TIME    last_delivery_time; /**< Time of the last acknowledged packet */
+    TIME    end_time;          /**< Time the simulation ended */
+    latency_histogram latency; /**< Milliseconds from the first transmission of a packet to its acknowledgement */
+    latency_histogram packet_retransmissions; /**< Retransmissions of each delivered packet */
+    latency_histogram queue_depth; /**< Packets waiting in the queue of a subnet found by each packet received */
+};
+
+/**
+ * Builds a dynamic atomic model, wrapped by the profiler if asked.
+ * The profiled model derives from the atomic model class, so its
+ * state is read the same way.
+ * @param profile true to time the functions of the model
+ * @param id id of the model
+ * @param args arguments of the constructor of the atomic model
+ * @return the dynamic atomic model
+ */
+template<template<typename T> class ATOMIC, typename TIME, typename... Args>
+std::shared_ptr<cadmium::dynamic::modeling::model> make_abp_profiled_model(bool profile, 
+                                                                          const char *id, 
+                                                                          Args&&... args){
+    if (profile){
+        return cadmium::dynamic::translate::make_dynamic_atomic_model
+               <profiled<ATOMIC>::template model, 
+                TIME, 
+                std::string, 
+                Args...>(id, std::string(id), std::forward<Args>(args)...);
+    }
+    return cadmium::dynamic::translate::make_dynamic_atomic_model
+           <ATOMIC, TIME, Args...>(id, std::forward<Args>(args)...);
+}
+
+/**
+ * Builds a dynamic atomic model, wrapped by the profiler and made
+ * resumable if asked. Either wrapper derives from the atomic model
+ * class, so its state is read the same way.
+ * @param profile true to time the functions of the model
+ * @param checkpointable true to keep the time of its last transition,
+ *                       so the run can be checkpointed and restored
+ * @param id id of the model
+ * @param args arguments of the constructor of the atomic model
+ * @return the dynamic atomic model
+ */
+template<template<typename T> class ATOMIC, typename TIME, typename... Args>
+std::shared_ptr<cadmium::dynamic::modeling::model> make_abp_atomic_model(bool profile, 
+                                                                        bool checkpointable, 
+                                                                        const char *id, 
+                                                                        Args&&... args){
+    if (checkpointable){
+        return make_abp_profiled_model
+               <resumable<ATOMIC>::template model, 
+                TIME, 
+                Args...>(profile, id, std::forward<Args>(args)...);
+    }
+    return make_abp_profiled_model<ATOMIC, TIME, Args...>(profile, id, std::forward<Args>(args)...);
+}
+
+/**
+ * Builds the sender of a flow: the alternating bit sender, or the
+ * window sender when the parameters give it a window
+ * @param parameters parameters of the atomic models
+ * @param profile true to time the functions of the model
+ * @param checkpointable true to build a model that can be checkpointed
+ * @param id id of the model
+ * @return the dynamic atomic model
+ */
+template<typename TIME>
+std::shared_ptr<cadmium::dynamic::modeling::model> make_abp_sender(const abp_parameters<TIME> &parameters, 
+                                                                  bool profile, 
+                                                                  bool checkpointable, 
+                                                                  const char *id){
+    if (parameters.window > 0){
+        return make_abp_atomic_model
+               <WindowSender, 
+                TIME, 
+                TIME, 
+                TIME, 
+                int64_t, 
+                window_mode, 
+                bool>(profile, 
+                      checkpointable, 
+                      id, 
+                      TIME(parameters.sender_preparation), 
+                      TIME(parameters.sender_timeout), 
+                      int64_t(parameters.window), 
+                      window_mode(parameters.mode), 
+                      bool(parameters.adaptive_timeout)
+                      );
+    }
+    return make_abp_atomic_model
+           <Sender,
+            TIME, 
+            TIME, 
+            TIME, 
+            bool>(profile, 
+                  checkpointable, 
+                  id, 
+                  TIME(parameters.sender_preparation), 
+                  TIME(parameters.sender_timeout), 
+                  bool(parameters.adaptive_timeout)
+                  );
+}
+
+/**
+ * Loss model and delay distribution of the subnets of a flow. The
+ * losses are independent unless bursts of losses are entered, and
+ * every distribution but the empirical one has the mean delay; the
+ * scale of the Pareto delay is the mean delay when its mean is infinite.
+ * @param parameters parameters of the atomic models, with the samples
+ *                   of the delay if it is empirical
+ * @return the channel given to the constructor of the subnets
+ */
+template<typename TIME>
+subnet_channel make_abp_channel(const abp_parameters<TIME> &parameters){
+    subnet_channel channel;
+    if (parameters.burst_enter > 0){
+        channel.loss = gilbert_elliott_loss{parameters.pass_probability, parameters.burst_pass, 
+                                            parameters.burst_enter, parameters.burst_exit};
+    } else{
+        channel.loss = bernoulli_loss{parameters.pass_probability};
+    }
+    double shape = parameters.delay_shape;
+    switch (parameters.delay){
+        case DELAY_CONSTANT:
+            channel.delay = constant_delay{parameters.delay_mean};
+            break;
+        case DELAY_EXPONENTIAL:
+            channel.delay = exponential_delay{parameters.delay_mean};
+            break;
+        case DELAY_PARETO:
+            channel.delay = pareto_delay{shape > 1 ? parameters.delay_mean * (shape - 1) / shape : 
+                                                     parameters.delay_mean, shape};
+            break;
+        case DELAY_EMPIRICAL:
+            channel.delay = empirical_delay{parameters.delay_samples};
+            break;
+        default:
+            channel.delay = normal_delay{std::normal_distribution<double>(parameters.delay_mean, 
+                                                                          parameters.delay_stddev)};
+    }
+    channel.delay_min = parameters.delay_min;
+    channel.resolution_ms = std::max<int64_t>(parameters.delay_resolution, 1);
+    return channel;
+}
+
+/**
+ * Queue and bandwidth of the subnets of a flow
+ * @param parameters parameters of the atomic models
+ * @return the queue given to the constructor of the subnets
+ */
+template<typename TIME>
+subnet_queue make_abp_queue(const abp_parameters<TIME> &parameters){
+    subnet_queue queue;
+    queue.capacity = parameters.queue_capacity;
+    queue.bandwidth = parameters.bandwidth;
+    queue.packet_size = parameters.packet_size;
+    return queue;
+}
+
+/**
+ * Builds the receiver of a flow, of the protocol of its sender
+ * @param parameters parameters of the atomic models
+ * @param profile true to time the functions of the model
+ * @param checkpointable true to build a model that can be checkpointed
+ * @param id id of the model
+ * @return the dynamic atomic model
+ */
+template<typename TIME>
+std::shared_ptr<cadmium::dynamic::modeling::model> make_abp_receiver(const abp_parameters<TIME> &parameters, 
+                                                                    bool profile, 
+                                                                    bool checkpointable, 
+                                                                    const char *id){
+    if (parameters.window > 0){
+        return make_abp_atomic_model
+               <WindowReceiver, 
+                TIME, 
+                TIME, 
+                int64_t, 
+                window_mode>(profile, 
+                             checkpointable, 
+                             id, 
+                             TIME(parameters.receiver_preparation), 
+                             int64_t(parameters.window), 
+                             window_mode(parameters.mode)
+                             );
+    }
+    return make_abp_atomic_model
+           <Receiver, 
+            TIME, 
+            TIME>(profile, 
+                  checkpointable, 
+                  id, 
+                  TIME(parameters.receiver_preparation)
+                  );
+}
+
+/**
+ * Structure that holds the ABPSimulator coupled model of one flow,
+ * a sender and a receiver over their own network, together with
+ * its atomic models.
+ */
+template<typename TIME>
+struct abp_flow{
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> simulator;
+    std::shared_ptr<cadmium::dynamic::modeling::model> sender;
+    std::shared_ptr<cadmium::dynamic::modeling::model> receiver;
+    std::shared_ptr<cadmium::dynamic::modeling::model> subnet1;
+    std::shared_ptr<cadmium::dynamic::modeling::model> subnet2;
+};
+
+/**
+ * Builds ABPSimulator -> Network<flow> for the flow of the given number.
+ * Its atomic models are sender<flow>, receiver<flow>, subnet<2 flow - 1>
+ * and subnet<2 flow>. The first subnet draws from the given generator
+ * and the second one from the next stream, so the generator of flow n
+ * is the seed moved to the stream 2 (n - 1) and flow 1 is the flow of
+ * make_abp_top_model.
+ * @param flow number of the flow, from 1
+ * @param id id of the ABPSimulator coupled model
+ * @param generator random generator of the first subnet
+ * @param parameters parameters of the atomic models
+ * @param profile true to time the functions of the atomic models
+ * @param checkpointable true to build atomic models that can be checkpointed
+ * @return the coupled model of the flow and its atomic models
+ */
+template<typename TIME>
+abp_flow<TIME> make_abp_flow(uint64_t flow, 
+                             const std::string &id, 
+                             const random_generator &generator, 
+                             const abp_parameters<TIME> &parameters, 
+                             bool profile, 
+                             bool checkpointable = false){
+    abp_flow<TIME> model;
+    std::string sender_id = "sender" + std::to_string(flow);
+    std::string receiver_id = "receiver" + std::to_string(flow);
+    std::string subnet1_id = "subnet" + std::to_string(2 * flow - 1);
+    std::string subnet2_id = "subnet" + std::to_string(2 * flow);
+    std::string network_id = "Network" + std::to_string(flow);
+    random_generator next_stream = generator;
+    next_stream.jump();
+
+    /**
+     * Identify output data which has been sent from the sender
+     * and receoved from the receiver, of the protocol asked
+     */
+    model.sender = make_abp_sender<TIME>(parameters, profile, checkpointable, sender_id.c_str());
+    model.receiver = make_abp_receiver<TIME>(parameters, profile, checkpointable, 
+                                             receiver_id.c_str());
+
+    /**
+     * Identify output data which has been receoved from the subnets.
+     * Both draw from the seed, each on its own stream
+     */
+    model.subnet1 = make_abp_atomic_model
+                    <Subnet, 
+                     TIME, 
+                     random_generator, 
+                     subnet_channel, 
+                     subnet_queue>(profile, 
+                                   checkpointable, 
+                                   subnet1_id.c_str(), 
+                                   random_generator(generator), 
+                                   make_abp_channel(parameters), 
+                                   make_abp_queue(parameters)
+                                   );
+    model.subnet2 = make_abp_atomic_model
+                    <Subnet, 
+                     TIME, 
+                     random_generator, 
+                     subnet_channel, 
+                     subnet_queue>(profile, 
+                                   checkpointable, 
+                                   subnet2_id.c_str(), 
+                                   std::move(next_stream), 
+                                   make_abp_channel(parameters), 
+                                   make_abp_queue(parameters)
+                                   );
+
+    /**
+     * Network coupled model made of the two subnets
+     */
+    cadmium::dynamic::modeling::Ports iports_Network = {
+        typeid(inp_1),
+        typeid(inp_2)
+    };
+    cadmium::dynamic::modeling::Ports oports_Network = {
+        typeid(outp_1),
+        typeid(outp_2)
+    };
+    cadmium::dynamic::modeling::Models submodels_Network = {
+        model.subnet1, 
+        model.subnet2
+    };
+    cadmium::dynamic::modeling::EICs eics_Network = {
+        cadmium::dynamic::translate::make_EIC<inp_1, 
+                                              subnet_defs::in>(subnet1_id
+                                                               ),
+        cadmium::dynamic::translate::make_EIC<inp_2, 
+                                              subnet_defs::in>(subnet2_id
+                                                               )
+    };
+    cadmium::dynamic::modeling::EOCs eocs_Network = {
+        cadmium::dynamic::translate::make_EOC<subnet_defs::out,
+                                              outp_1>(subnet1_id
+                                                      ),
+        cadmium::dynamic::translate::make_EOC<subnet_defs::out,
+                                              outp_2>(subnet2_id
+                                                      )
+    };
+    cadmium::dynamic::modeling::ICs ics_Network = {};
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> NETWORK = 
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(network_id, 
+                                                                submodels_Network, 
+                                                                iports_Network, 
+                                                                oports_Network, 
+                                                                eics_Network, 
+                                                                eocs_Network, 
+                                                                ics_Network 
+                                                                );
+
+    /**
+     * ABP simulator coupled model made of the sender, the receiver
+     * and the network
+     */
+    cadmium::dynamic::modeling::Ports iports_ABPSimulator = {
+        typeid(inp_control)
+    };
+    cadmium::dynamic::modeling::Ports oports_ABPSimulator = {
+        typeid(outp_ack),
+        typeid(outp_pack)
+    };
+    cadmium::dynamic::modeling::Models submodels_ABPSimulator = {
+        model.sender, 
+        model.receiver,
+        NETWORK
+    };
+    cadmium::dynamic::modeling::EICs eics_ABPSimulator = {
+        cadmium::dynamic::translate::make_EIC<inp_control, 
+                                              sender_defs::controlIn>(sender_id
+                                                                      )
+    };
+    cadmium::dynamic::modeling::EOCs eocs_ABPSimulator = {
+        cadmium::dynamic::translate::make_EOC<sender_defs::packetSentOut,
+                                              outp_pack>(sender_id
+                                                         ),
+        cadmium::dynamic::translate::make_EOC<sender_defs::ackReceivedOut,
+                                              outp_ack>(sender_id
+                                                        )
+    };
+    cadmium::dynamic::modeling::ICs ics_ABPSimulator = {
+        cadmium::dynamic::translate::make_IC<sender_defs::dataOut, 
+                                             inp_1>(sender_id,
+                                                    network_id
+                                                    ),
+        cadmium::dynamic::translate::make_IC<outp_2, 
+                                             sender_defs::ackIn>(network_id,
+                                                                 sender_id),
+        cadmium::dynamic::translate::make_IC<receiver_defs::out, 
+                                             inp_2>(receiver_id,
+                                                    network_id
+                                                    ),
+        cadmium::dynamic::translate::make_IC<outp_1, 
+                                             receiver_defs::in>(network_id,
+                                                                receiver_id
+                                                                )
+    };
+    model.simulator = 
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(id, 
+                                                                submodels_ABPSimulator, 
+                                                                iports_ABPSimulator, 
+                                                                oports_ABPSimulator, 
+                                                                eics_ABPSimulator, 
+                                                                eocs_ABPSimulator, 
+                                                                ics_ABPSimulator 
+                                                                );
+    return model;
+}
+
+/**
+ * Builds TOP -> ABPSimulator -> Network and returns it together
+ * with the atomic models.
+ * @param input_file path of the input file of the control generator
+ * @param seed seed of the random generators of the subnets
+ * @param parameters parameters of the atomic models
+ * @param profile true to time the functions of the atomic models
+ * @param checkpointable true to build atomic models that can be checkpointed
+ * @return the top model and its atomic models
+ */
+template<typename TIME>
+abp_top_model<TIME> make_abp_top_model(const char *input_file, 
+                                       uint64_t seed = DEFAULT_RANDOM_SEED, 
+                                       const abp_parameters<TIME> &parameters = 
+                                                    abp_parameters<TIME>(), 
+                                       bool profile = false, 
+                                       bool checkpointable = false){
+    abp_top_model<TIME> model;
+
+    /**
+     * Initialized generator which has output file path, Time and 
+     * with given input generates the output
+     */
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator_con = 
+                    make_abp_atomic_model
+                    <ApplicationGen, 
+                     TIME, 
+                     const char* >(profile, 
+                                   checkpointable, 
+                                   "generator_con" , 
+                                   std::move(input_file)
+                                   );
+
+    /**
+     * The sender, the receiver and the network of the only flow
+     */
+    abp_flow<TIME> flow = make_abp_flow<TIME>(1, "ABPSimulator", 
+                                              random_generator(seed, 0), 
+                                              parameters, profile, checkpointable);
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> ABPSimulator = flow.simulator;
+    model.generator = generator_con;
+    model.sender = flow.sender;
+    model.receiver = flow.receiver;
+    model.subnet1 = flow.subnet1;
+    model.subnet2 = flow.subnet2;
+
+    /**
+     * TOP coupled model made of the control generator and
+     * the ABP simulator
+     */
+    cadmium::dynamic::modeling::Ports iports_TOP = {};
+    cadmium::dynamic::modeling::Ports oports_TOP = {
+        typeid(outp_pack),
+        typeid(outp_ack)
+    };
+    cadmium::dynamic::modeling::Models submodels_TOP = {
+        generator_con, 
+        ABPSimulator
+    };
+    cadmium::dynamic::modeling::EICs eics_TOP = {};
+    cadmium::dynamic::modeling::EOCs eocs_TOP = {
+        cadmium::dynamic::translate::make_EOC<outp_pack,
+                                              outp_pack>("ABPSimulator"
+                                                         ),
+        cadmium::dynamic::translate::make_EOC<outp_pack,
+                                              outp_ack>("ABPSimulator"
+                                                       )
+    };
+    cadmium::dynamic::modeling::ICs ics_TOP = {
+        cadmium::dynamic::translate::make_IC<iestream_input_defs<message_t>::out,
+                                                                 inp_control>("generator_con",
+                                                                              "ABPSimulator"
+                                                                              )
+    };
+    model.top = 
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>( "TOP", 
+                                                                submodels_TOP, 
+                                                                iports_TOP, 
+                                                                oports_TOP, 
+                                                                eics_TOP, 
+                                                                eocs_TOP, 
+                                                                ics_TOP 
+                                                                );
+    return model;
+}
+
+/**
+ * Reads the results measured by a sender, which the alternating bit
+ * sender and the window sender name alike
+ * @param sender sender atomic model
+ * @param results results the measures are set in
+ */
+template<typename TIME, typename SENDER>
+void collect_sender_results(const SENDER &sender, abp_results<TIME> &results){
+    results.packets_delivered = sender.state.packets_delivered;
+    results.packets_sent = sender.state.packets_sent;
+    results.retransmissions = sender.state.retransmissions;
+    results.last_delivery_time = sender.state.last_delivery_time;
+    results.latency = sender.state.latency;
+    results.packet_retransmissions = sender.state.packet_retransmission_counts;
+}
+
+/**
+ * Sets the counts of the receiver of a run in its results
+ * @param receiver receiver atomic model
+ * @param results results the counts are set in
+ */
+template<typename TIME, typename RECEIVER>
+void collect_receiver_results(const RECEIVER &receiver, abp_results<TIME> &results){
+    results.packets_received = receiver.state.packets_received;
+    results.duplicates = receiver.state.duplicates;
+}
+
+/**
+ * Reads the aggregate results of a finished run from the state
+ * of the sender, the receiver and the subnets. The dynamic atomic model inherits
+ * from the atomic class so it can be cast to it to reach its state.
+ * @param model top model built by make_abp_top_model, or flow
+ *              built by make_abp_flow
+ * @param end_time time the simulation ended, given by the runner
+ * @return the results of the run
+ */
+template<typename TIME, template<typename T> class MODEL>
+abp_results<TIME> collect_abp_results(const MODEL<TIME> &model, const TIME &end_time){
+    abp_results<TIME> results;
+    results.end_time = end_time;
+    if (const Sender<TIME> *sender = dynamic_cast<const Sender<TIME>*>(model.sender.get())){
+        collect_sender_results(*sender, results);
+    } else{
+        collect_sender_results(*dynamic_cast<const WindowSender<TIME>*>(model.sender.get()), 
+                               results);
+    }
+    if (const Receiver<TIME> *receiver = dynamic_cast<const Receiver<TIME>*>(model.receiver.get())){
+        collect_receiver_results(*receiver, results);
+    } else{
+        collect_receiver_results(*dynamic_cast<const WindowReceiver<TIME>*>(model.receiver.get()), 
+                                 results);
+    }
+    results.packets_lost = 0;
+    for (const auto &model_subnet : {model.subnet1, model.subnet2}){
+        const Subnet<TIME> &subnet = *std::dynamic_pointer_cast<Subnet<TIME>>(model_subnet);
+        results.packets_lost += subnet.state.lost;
+        results.packets_dropped += subnet.state.dropped;
+        results.queue_depth.merge(subnet.state.queue_depth);
+    }
+    return results;
+}
+
+/**
+ * Prints the aggregate results of a run, with the drops and the
+ * depth of the queues of the subnets if they have one.
+ * @param os the output stream
+ * @param results results returned by collect_abp_results
+ */
+template<typename TIME>
+void print_abp_results(std::ostream &os, const abp_results<TIME> &results){
+    os << "Packets delivered: " << results.packets_delivered << endl;
+    os << "Packets sent: " << results.packets_sent << endl;
+    os << "Retransmissions: " << results.retransmissions << endl;
+    os << "Duplicates received: " << results.duplicates << endl;
+    os << "Packets lost: " << results.packets_lost << endl;
+    os << "Last delivery time: " << results.last_delivery_time << endl;
+    os << "Final simulation time: " << results.end_time << endl;
+    print_histogram(os, "Packet latency (ms)", results.latency);
+    print_histogram(os, "Retransmissions per packet", results.packet_retransmissions);
+    if (results.queue_depth.count() > 0){
+        os << "Packets dropped by the queues: " << results.packets_dropped << endl;
+        print_histogram(os, "Queue depth (packets)", results.queue_depth);
+    }
+}
+
+#endif // __ABP_TOP_MODEL_HPP__
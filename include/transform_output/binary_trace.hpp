@@ -0,0 +1,174 @@
+/** \brief This header file declares the binary trace of the ABP simulator.
+ *
+ *  The binary trace holds the same information as the simulator log in
+ *  fixed size records. The model and port names, repeated on every line
+ *  of the log, are interned: a record holds the id of the name and the
+ *  names are written once, in a table at the end of the file found from
+ *  the header. Messages are stored as their fields. Anything the records
+ *  cannot hold exactly is interned as text, so decoding the trace gives
+ *  back the log byte for byte, and its table.
+ *
+ *  Records follow the lines of the log:
+ *      - a time line is a TRACE_TIME record
+ *      - an output line is a TRACE_MODEL record, with the number of its
+ *        ports, followed for each port by a TRACE_PORT record, with the
+ *        number of its values, and a TRACE_VALUE record per value
+ */
+
+#ifndef __BINARY_TRACE_HPP__
+#define __BINARY_TRACE_HPP__
+
+#include <stdint.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../data_structures/byte_order.hpp"
+
+#define BINARY_TRACE_MAGIC "ABPTRACE"
+#define BINARY_TRACE_VERSION 1
+#define BINARY_TRACE_HEADER_SIZE 40
+#define BINARY_TRACE_RECORD_SIZE 16
+
+/**
+ * Header of a binary trace file, stored as BINARY_TRACE_HEADER_SIZE
+ * bytes, little endian
+ */
+struct binary_trace_header {
+	char magic[8];         ///< BINARY_TRACE_MAGIC, without its terminating zero
+	uint32_t version;      ///< BINARY_TRACE_VERSION
+	uint32_t record_size;  ///< bytes of a record
+	uint64_t record_count; ///< number of records following the header
+	uint64_t names_offset; ///< position of the table of names in the file
+	uint64_t name_count;   ///< number of names, each one its uint32 length and its characters
+
+	/**
+	 * Stores the header, little endian
+	 */
+	void encode(char *bytes) const {
+		memcpy(bytes, magic, sizeof(magic));
+		store_little_endian(version, bytes + 8, 4);
+		store_little_endian(record_size, bytes + 12, 4);
+		store_little_endian(record_count, bytes + 16, 8);
+		store_little_endian(names_offset, bytes + 24, 8);
+		store_little_endian(name_count, bytes + 32, 8);
+	}
+
+	/**
+	 * Loads the header stored by encode
+	 */
+	void decode(const char *bytes) {
+		memcpy(magic, bytes, sizeof(magic));
+		version = static_cast<uint32_t>(load_little_endian(bytes + 8, 4));
+		record_size = static_cast<uint32_t>(load_little_endian(bytes + 12, 4));
+		record_count = load_little_endian(bytes + 16, 8);
+		names_offset = load_little_endian(bytes + 24, 8);
+		name_count = load_little_endian(bytes + 32, 8);
+	}
+};
+
+/**
+ * Kinds of the records of a binary trace
+ */
+enum binary_trace_kind : uint8_t {
+	TRACE_TIME,       ///< time line, value is the time in milliseconds
+	TRACE_MODEL,      ///< output line, id is the model and value the number of ports
+	TRACE_PORT,       ///< port of an output line, id is the port and value the number of values
+	TRACE_VALUE,      ///< message, value is the packet number and id the payload length
+	TRACE_TIME_TEXT,  ///< time line kept as the name id
+	TRACE_VALUE_TEXT, ///< value kept as the name id
+	TRACE_LINE_TEXT   ///< any other line kept as the name id
+};
+
+/**
+ * Record of a binary trace, stored as BINARY_TRACE_RECORD_SIZE bytes,
+ * little endian
+ */
+struct binary_trace_record {
+	int64_t value;     ///< time, count or packet number depending on the kind
+	uint32_t id;       ///< name id or payload length depending on the kind
+	uint8_t kind;      ///< binary_trace_kind
+	int8_t alt_bit;    ///< alternating bit of a TRACE_VALUE
+	uint16_t reserved; ///< zero
+
+	/**
+	 * Stores the record, little endian
+	 */
+	void encode(char *bytes) const {
+		store_little_endian(static_cast<uint64_t>(value), bytes, 8);
+		store_little_endian(id, bytes + 8, 4);
+		bytes[12] = static_cast<char>(kind);
+		bytes[13] = static_cast<char>(alt_bit);
+		store_little_endian(reserved, bytes + 14, 2);
+	}
+
+	/**
+	 * Loads the record stored by encode
+	 */
+	void decode(const char *bytes) {
+		value = static_cast<int64_t>(load_little_endian(bytes, 8));
+		id = static_cast<uint32_t>(load_little_endian(bytes + 8, 4));
+		kind = static_cast<uint8_t>(bytes[12]);
+		alt_bit = static_cast<int8_t>(bytes[13]);
+		reserved = static_cast<uint16_t>(load_little_endian(bytes + 14, 2));
+	}
+};
+
+/**
+ *  Stream buffer given to the loggers, or to an async_streambuf, that
+ *  writes the log as a binary trace. It splits the log in lines and
+ *  encodes each complete line.
+ */
+class binary_trace_streambuf : public std::streambuf {
+public:
+	/**
+	 * Opens the trace file and writes a header without records
+	 * @param file_name file the trace is written to
+	 * @return false if the file cannot be written
+	 */
+	bool open(const char *file_name);
+
+	/**
+	 * Writes the table of names and the final header, and closes the file
+	 */
+	void close();
+
+	/**
+	 * @return true if a trace file is open
+	 */
+	bool is_open() const;
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char *s, std::streamsize n) override;
+
+private:
+	void encode_line(const std::string &line);
+	bool encode_output_line(const std::string &line);
+	void write_record(binary_trace_kind kind, int64_t value, uint32_t id, int8_t alt_bit = 0);
+	void write_records();
+	uint32_t intern(const std::string &name);
+
+	std::ofstream file;
+	std::string line;
+	std::vector<binary_trace_record> records;
+	uint64_t record_count = 0;
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<std::string> names;
+};
+
+/**
+ *  Decodes a binary trace, writing the log it was made from and its table.
+ *  @param trace_file_name binary trace file
+ *  @param raw stream the log is written to, or nullptr
+ *  @param table stream the table is written to, or nullptr
+ *  @return false if the file is not a valid binary trace
+ */
+bool decode_binary_trace(const char *trace_file_name, std::ostream *raw, std::ostream *table);
+
+
+#endif // __BINARY_TRACE_HPP__
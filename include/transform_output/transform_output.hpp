@@ -14,11 +14,33 @@
  *      2- Sender
  *      3- Receiver
  *      4- Subnet
+ *
+ *  The same table can be generated while the simulation runs by giving
+ *  the loggers a transform_sink, so the log does not need to be read again.
+ *  The sink hands the log to a writer thread in large blocks, so the
+ *  simulation does not wait for the table to be made and written.
+ *  It can instead write the log as a binary trace, see binary_trace.hpp.
  */
 
 #ifndef __TRANSFORM_OUTPUT_HPP__
 #define __TRANSFORM_OUTPUT_HPP__
 
+#include <condition_variable>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_trace.hpp"
+
+/**
+ * Size in bytes of the blocks handed to the writer thread
+ */
+#define ASYNC_BLOCK_SIZE (1 << 20)
+
 /** 
  *  This function is used to transform the ABP simulator generated output 
  *  to a table structured and readable format. It takes as input the 
@@ -30,5 +52,157 @@
 
 void transform_output(const char *ip_file_name, const char *op_file_name);
 
+/**
+ *  This class transforms the simulator log one line at a time and
+ *  writes the rows of the table to an output stream. It keeps the
+ *  time of the last time line read and the fields of the last row,
+ *  so the lines must be given in the order they are logged.
+ */
+class output_transformer {
+public:
+	/**
+	 * @param table output stream the table is written to
+	 */
+	explicit output_transformer(std::ostream &table);
+
+	/**
+	 * Writes the column names of the table
+	 */
+	void write_header();
+
+	/**
+	 * Transforms one line of the log, without its end of line
+	 * @param line line of the log
+	 */
+	void transform_line(const std::string &line);
+
+private:
+	void transform_value(const std::string &value);
+
+	std::ostream &table;
+	std::string time, port, port_value, component, packet_num, altern_bit;
+};
+
+/**
+ *  Stream buffer given to the loggers. It splits the log written to it
+ *  in lines and gives each complete line to an output_transformer.
+ *  The log can also be copied as it is to another stream buffer.
+ */
+class transform_streambuf : public std::streambuf {
+public:
+	/**
+	 * @param transformer transformer receiving the lines of the log
+	 * @param raw stream buffer receiving a copy of the log, or nullptr
+	 */
+	explicit transform_streambuf(output_transformer &transformer, 
+	                             std::streambuf *raw = nullptr);
+
+	/**
+	 * @param raw stream buffer receiving a copy of the log, or nullptr
+	 */
+	void copy_to(std::streambuf *raw);
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char *s, std::streamsize n) override;
+	int sync() override;
+
+private:
+	output_transformer &transformer;
+	std::streambuf *raw;
+	std::string line;
+};
+
+/**
+ *  Stream buffer writing to another stream buffer from a writer thread.
+ *  What is written to it fills a block, without locking, and full
+ *  blocks are handed to the writer thread, which writes them to the
+ *  target while the next block is filled. At most two blocks exist,
+ *  so writing waits for the writer thread only when it is one whole
+ *  block behind. Syncing does not hand the block over, stop() does.
+ */
+class async_streambuf : public std::streambuf {
+public:
+	/**
+	 * @param block_size size in bytes of the blocks
+	 */
+	explicit async_streambuf(size_t block_size = ASYNC_BLOCK_SIZE);
+	~async_streambuf();
+
+	/**
+	 * Starts the writer thread
+	 * @param target stream buffer the blocks are written to
+	 */
+	void start(std::streambuf *target);
+
+	/**
+	 * Hands over the last block, waits until the writer thread has
+	 * written everything and syncs the target
+	 */
+	void stop();
+
+protected:
+	int_type overflow(int_type c) override;
+	int sync() override;
+
+private:
+	void hand_over();
+	void write_blocks();
+
+	std::vector<char> front, back;
+	size_t back_size;
+	bool back_full, stopping;
+	std::streambuf *target;
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::thread writer;
+};
+
+/**
+ *  Sink for the cadmium loggers that writes the transformed table
+ *  while the simulation runs, and optionally the log itself.
+ *  A sink provider returns stream() from its sink() function.
+ *  The table and the log are written by a writer thread unless the
+ *  sink is opened synchronous.
+ */
+class transform_sink {
+public:
+	transform_sink();
+
+	/**
+	 * Opens the output files and writes the column names of the table
+	 * @param table_file_name file the table is written to
+	 * @param raw_file_name file the log is written to, or nullptr to skip it
+	 * @param asynchronous true to write from the writer thread
+	 */
+	void open(const char *table_file_name, const char *raw_file_name = nullptr,
+	          bool asynchronous = true);
+
+	/**
+	 * Opens a binary trace file instead of the log and its table.
+	 * The trace is encoded by the writer thread.
+	 * @param trace_file_name file the binary trace is written to
+	 */
+	void open_binary(const char *trace_file_name);
+
+	/**
+	 * Writes what is left, stops the writer thread and closes the output files
+	 */
+	void close();
+
+	/**
+	 * @return the stream the loggers write to
+	 */
+	std::ostream& stream();
+
+private:
+	std::ofstream table_file, raw_file;
+	output_transformer transformer;
+	transform_streambuf buffer;
+	binary_trace_streambuf binary;
+	async_streambuf async;
+	std::ostream out;
+};
+
 
-#endif // __TRANSFORM_OUTPUT_HPP__
\ No newline at end of file
+#endif // __TRANSFORM_OUTPUT_HPP__
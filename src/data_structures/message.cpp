@@ -1,35 +1,127 @@
-
 /** \brief Source file for message source code
  * 
  * Contains input and output stream methods from the header file
- * which return float values of message structure
+ * which write and read the fields of the message structure
  */
 
 #include <math.h> 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include "../../include/data_structures/message.hpp"
+#include "../../include/data_structures/byte_order.hpp"
 
 /** Output stream
  * it is an operator applied to an output stream is known as 
- * insertion operator, and performs formatted output character sequence
+ * insertion operator, and performs formatted output character sequence.
+ * The fields not used by the message are not written.
  * @param[out] os reference to ostream - output stream
  * @param[in] msg const reference to struct message_t - message
  */
 ostream& operator<<(ostream& os, const message_t& msg){
-	os << msg.value;
+	os << msg.packet_num;
+    if (msg.alt_bit != message_t::NO_BIT || msg.payload_length != 0){
+        os << ':' << (int)msg.alt_bit;
+    }
+    if (msg.payload_length != 0){
+        os << ':' << msg.payload_length;
+    }
     return os;
 }
 
+/** Message parser
+ * Reads packet_num[:alt_bit[:payload_length]] from the characters
+ * [begin, end). The message is not changed if they are not valid,
+ * a field beyond INT64_MAX included.
+ * @param[in]  begin first character of the word
+ * @param[in]  end character following the word
+ * @param[out] msg reference to struct message_t - message
+ * @return false if the word is not a message
+ */
+bool parse_input(const char *begin, const char *end, message_t& msg){
+    const char *c = begin;
+    int64_t fields[3] = {0, message_t::NO_BIT, 0};
+    int count = 0;
+    while (count < 3){
+        bool negative = c < end && *c == '-' && count < 2;
+        if (negative){
+            c++;
+        }
+        if (c == end || *c < '0' || *c > '9'){
+            return false;
+        }
+        int64_t field = 0;
+        while (c < end && *c >= '0' && *c <= '9'){
+            int digit = *c++ - '0';
+            if (field > (INT64_MAX - digit) / 10){
+                return false;
+            }
+            field = field * 10 + digit;
+        }
+        fields[count++] = negative ? -field : field;
+        if (c == end || *c != ':'){
+            break;
+        }
+        c++;
+    }
+    if (c != end || fields[1] < message_t::NO_BIT || fields[1] > 1 || 
+        fields[2] > UINT32_MAX){
+        return false;
+    }
+    msg = message_t(fields[0], (int8_t)fields[1], (uint32_t)fields[2]);
+    return true;
+}
+
+/** Binary message reader
+ * Reads the packet number, the payload length and the alternating bit,
+ * little endian
+ * @param[in]  bytes bytes of the message in the record
+ * @param[in]  size number of bytes of the message in the record
+ * @param[out] msg reference to struct message_t - message
+ * @return false if the bytes are not a message
+ */
+bool decode_input(const char *bytes, size_t size, message_t& msg){
+    message_t read;
+    if (size < MESSAGE_RECORD_SIZE){
+        return false;
+    }
+    read.packet_num = (int64_t)load_little_endian(bytes, 8);
+    read.payload_length = (uint32_t)load_little_endian(bytes + 8, 4);
+    read.alt_bit = (int8_t)load_little_endian(bytes + 12, 1);
+    if (read.alt_bit < message_t::NO_BIT || read.alt_bit > 1){
+        return false;
+    }
+    msg = read;
+    return true;
+}
+
+/** Binary message writer
+ * Writes the packet number, the payload length, the alternating bit,
+ * little endian, and zeros as padding
+ * @param[in]  msg const reference to struct message_t - message
+ * @param[out] bytes MESSAGE_RECORD_SIZE bytes of the message
+ */
+void encode_input(const message_t& msg, char *bytes){
+    memset(bytes, 0, MESSAGE_RECORD_SIZE);
+    store_little_endian((uint64_t)msg.packet_num, bytes, 8);
+    store_little_endian(msg.payload_length, bytes + 8, 4);
+    store_little_endian((uint8_t)msg.alt_bit, bytes + 12, 1);
+}
+
 /** Input stream
- * it is an operator applied to an output stream is known as 
- * insertion operator, and performs formatted output character sequence
+ * it is an operator applied to an input stream is known as 
+ * extraction operator, and reads the next word as a message.
+ * The stream fails if the word is not a message.
  * @param[out]  is reference to istream - iutput stream
- * @param[in]  msg const reference to struct message_t - message
+ * @param[in]  msg reference to struct message_t - message
  */
 istream& operator>> (istream& is, message_t& msg){
-    is >> msg.value;
+    string text;
+    if ((is >> text) && !parse_input(text.data(), text.data() + text.size(), msg)){
+        is.setstate(ios::failbit);
+    }
     return is;
 }
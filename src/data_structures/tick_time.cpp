@@ -0,0 +1,89 @@
+/** \brief Source file for the integer tick time
+ * 
+ * Contains the conversions of TickTime from and to its
+ * HH:MM:SS:mmm representation
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../../include/data_structures/tick_time.hpp"
+
+/**
+ * Parses HH:MM:SS:mmm, fields may be omitted from the right
+ * @param text the time
+ * @param ticks milliseconds read
+ * @return false if the text is not a time
+ */
+static bool parse_ticks(const char *text, int64_t &ticks){
+    static const int64_t UNITS[] = {3600000, 60000, 1000, 1};
+    if (std::string(text) == "inf"){
+        ticks = TickTime::INF;
+        return true;
+    }
+    ticks = 0;
+    for (int i = 0; i < 4; i++){
+        char *end;
+        if (*text < '0' || *text > '9'){
+            return false;
+        }
+        ticks += strtoll(text, &end, 10) * UNITS[i];
+        if (*end == '\0'){
+            return true;
+        }
+        if (*end != ':'){
+            return false;
+        }
+        text = end + 1;
+    }
+    return false;
+}
+
+TickTime::TickTime(const char *text) : ticks(0){
+    if (!parse_ticks(text, ticks)){
+        throw std::invalid_argument(std::string("not a time: ") + text);
+    }
+}
+
+/** Input stream
+ * Reads a time from the next word of the stream
+ * @param[out] is reference to istream - input stream
+ * @param[in] time reference to TickTime - time read
+ */
+std::istream& operator>>(std::istream &is, TickTime &time){
+    std::string text;
+    int64_t ticks;
+    if (is >> text){
+        if (parse_ticks(text.c_str(), ticks)){
+            time = TickTime::from_ticks(ticks);
+        } else{
+            is.setstate(std::ios::failbit);
+        }
+    }
+    return is;
+}
+
+/** Output stream
+ * Writes the time as HH:MM:SS:mmm or inf
+ * @param[out] os reference to ostream - output stream
+ * @param[in] time const reference to TickTime - time written
+ */
+std::ostream& operator<<(std::ostream &os, const TickTime &time){
+    int64_t ticks = time.count();
+    if (ticks == TickTime::INF){
+        return os << "inf";
+    }
+    if (ticks == -TickTime::INF){
+        return os << "-inf";
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%s%02lld:%02lld:%02lld:%03lld", 
+             ticks < 0 ? "-" : "", 
+             (long long)(llabs(ticks) / 3600000), 
+             (long long)(llabs(ticks) / 60000 % 60), 
+             (long long)(llabs(ticks) / 1000 % 60), 
+             (long long)(llabs(ticks) % 1000));
+    return os << text;
+}
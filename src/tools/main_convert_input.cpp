@@ -0,0 +1,159 @@
+/** \brief Main source file of the input converter
+ *
+ * Converts an input file of the simulator between the text format,
+ * lines "HH:MM:SS:mmm message", and the binary event format read by
+ * iestream_input: a header followed by fixed size records holding
+ * the time in milliseconds and the message. The direction is chosen
+ * from the input file, a binary file is written back as text and a
+ * text file is written as binary. A line or a record that is not
+ * valid stops the conversion with an error, instead of ending the
+ * output early as the end of the input would.
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "../../lib/vendor/iestream.hpp"
+#include "../../include/data_structures/message.hpp"
+#include "../../include/data_structures/tick_time.hpp"
+
+using namespace std;
+
+/**
+ * Size of a record of the binary format, the time and the message
+ */
+#define CONVERT_RECORD_SIZE (sizeof(int64_t) + MESSAGE_RECORD_SIZE)
+
+/**
+ * Tells if a file starts with the header of the binary format
+ * @param file_path path of the file
+ * @return true if the file is a binary event file
+ */
+bool is_binary_file(const char *file_path){
+    char magic[8];
+    FILE *file = fopen(file_path, "rb");
+    if (file == nullptr){
+        return false;
+    }
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                  memcmp(magic, IESTREAM_BINARY_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return binary;
+}
+
+/**
+ * Writes the inputs of a text file as a binary event file. The
+ * header is written again with the count of records at the end.
+ * @param parser parser of the input file
+ * @param file output file
+ * @return number of records written
+ */
+uint64_t write_binary(Parser<TickTime, message_t> &parser, FILE *file){
+    iestream_binary_header header;
+    char header_bytes[IESTREAM_BINARY_HEADER_SIZE];
+    memcpy(header.magic, IESTREAM_BINARY_MAGIC, sizeof(header.magic));
+    header.version = IESTREAM_BINARY_VERSION;
+    header.record_size = CONVERT_RECORD_SIZE;
+    header.record_count = 0;
+    header.encode(header_bytes);
+    fwrite(header_bytes, sizeof(header_bytes), 1, file);
+
+    pair<TickTime, message_t> timed_input;
+    char record[CONVERT_RECORD_SIZE];
+    while (parser.next_timed_input(timed_input)){
+        int64_t ms = timed_input.first.count();
+        store_little_endian(uint64_t(ms), record, sizeof(ms));
+        encode_input(timed_input.second, record + sizeof(ms));
+        fwrite(record, sizeof(record), 1, file);
+        header.record_count++;
+    }
+
+    fseek(file, 0, SEEK_SET);
+    header.encode(header_bytes);
+    fwrite(header_bytes, sizeof(header_bytes), 1, file);
+    return header.record_count;
+}
+
+/**
+ * Writes the records of a binary event file as text lines
+ * @param parser parser of the input file
+ * @param os output file
+ * @return number of lines written
+ */
+uint64_t write_text(Parser<TickTime, message_t> &parser, ostream &os){
+    uint64_t lines = 0;
+    pair<TickTime, message_t> timed_input;
+    while (parser.next_timed_input(timed_input)){
+        os << timed_input.first << " " << timed_input.second << "\n";
+        lines++;
+    }
+    return lines;
+}
+
+/**
+ * Tells where the input of a parser is not valid
+ * @param parser parser that failed
+ * @param binary true if the input file is a binary event file
+ * @param os stream the error is written to
+ */
+void report_error(const Parser<TickTime, message_t> &parser, bool binary, ostream &os){
+    if (!binary){
+        os << "line " << parser.error_line();
+    } else if (parser.error_record() == 0){
+        os << "the header";
+    } else{
+        os << "the record " << parser.error_record();
+    }
+    os << ", at offset " << parser.error_offset() << ", is not valid";
+}
+
+/**\brief  Main function
+ *
+ * Converts the input file given as the first argument to the output
+ * file given as the second one. Exits with 2 if the input file is
+ * not valid, after the inputs before the error are converted.
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    if (argc != 3){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " input file (text or binary) output file" << endl;
+        return 1;
+    }
+
+    bool binary = is_binary_file(argv[1]);
+    Parser<TickTime, message_t> parser(argv[1]);
+    uint64_t count;
+    if (binary){
+        ofstream os(argv[2]);
+        if (!os){
+            cout << "cannot write " << argv[2] << endl;
+            return 1;
+        }
+        count = write_text(parser, os);
+    } else{
+        FILE *file = fopen(argv[2], "wb");
+        if (file == nullptr){
+            cout << "cannot write " << argv[2] << endl;
+            return 1;
+        }
+        count = write_binary(parser, file);
+        fclose(file);
+    }
+
+    cout << "Converted " << count << (binary ? " records to text" : " lines to binary")
+         << endl;
+    if (parser.failed()){
+        cout << "cannot convert " << argv[1] << ": ";
+        report_error(parser, binary, cout);
+        cout << endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+/** \brief Main source file of the binary trace decoder
+ *
+ * Decodes a binary trace written by the simulator with --binary-trace
+ * into the log the simulator writes without it and its table.
+ */
+
+#include <iostream>
+#include <fstream>
+
+#include "../../include/transform_output/binary_trace.hpp"
+
+//define default output files
+#define DECODE_OUTPUT_FILE_PATH "data/top_model/abp_output.txt"
+#define DECODE_TRANSFORM_OUTPUT_FILE_PATH "data/top_model/abp_output_transform.txt"
+
+using namespace std;
+
+/**\brief  Main function
+ *
+ * Decodes the binary trace given as the first argument to the log
+ * and table files given as the next ones, or to the default files
+ * of the simulator
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    if (argc != 2 && argc != 4){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " binary trace file [log file table file]" << endl;
+        return 1;
+    }
+
+    ofstream raw(argc == 4 ? argv[2] : DECODE_OUTPUT_FILE_PATH);
+    ofstream table(argc == 4 ? argv[3] : DECODE_TRANSFORM_OUTPUT_FILE_PATH);
+    if (!decode_binary_trace(argv[1], &raw, &table)){
+        cout << argv[1] << " is not a valid binary trace" << endl;
+        return 1;
+    }
+    return 0;
+}
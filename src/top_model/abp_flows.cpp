@@ -0,0 +1,59 @@
+/** \brief Source file for the multi-flow top model of the ABP Simulator
+ *
+ * Reads the flows file and measures the memory of the process.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../../include/top_model/abp_flows.hpp"
+
+using namespace std;
+
+bool read_flow_groups(const char *file,
+                      const abp_sweep_point &defaults,
+                      vector<abp_flow_group> &groups){
+    ifstream is(file);
+    if (!is){
+        return false;
+    }
+    groups.clear();
+    string line, name;
+    while (getline(is, line)){
+        istringstream fields(line);
+        abp_flow_group group;
+        if (!(fields >> name) || name[0] == '#'){
+            continue;
+        }
+        istringstream count(name);
+        if (!(count >> group.flows) || !count.eof() || group.flows == 0){
+            return false;
+        }
+        group.parameters = defaults;
+        while (fields >> name){
+            int i = find(ABP_PARAMETER_NAMES, ABP_PARAMETER_NAMES + ABP_PARAMETER_COUNT,
+                         name) - ABP_PARAMETER_NAMES;
+            double value;
+            if (i == ABP_PARAMETER_COUNT || !(fields >> value) || !valid_parameter_value(i, value)){
+                return false;
+            }
+            group.parameters[i] = value;
+        }
+        groups.push_back(group);
+    }
+    return !groups.empty();
+}
+
+size_t resident_memory(){
+    ifstream statm("/proc/self/statm");
+    size_t pages, resident;
+    if (!(statm >> pages >> resident)){
+        return 0;
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,190 @@
+/** \brief Source file for the command line options of the ABP Simulator
+ *
+ * Parses the command line given to the executables that run the
+ * ABP Simulator top model.
+ */
+
+#include <string>
+#include <cstdlib>
+
+#include "../../include/top_model/abp_options.hpp"
+
+using namespace std;
+
+/**
+ * Reads the number following a flag
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param i index of the flag, moved to the number
+ * @param value number read
+ * @return false if there is no number after the flag
+ */
+static bool parse_number(int argc, char ** argv, int &i, uint64_t &value){
+    char *end;
+    if (++i == argc){
+        return false;
+    }
+    value = strtoull(argv[i], &end, 0);
+    return *argv[i] != '\0' && *argv[i] != '-' && *end == '\0';
+}
+
+/**
+ * Reads the text following a flag
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ * @param i index of the flag, moved to the text
+ * @param value text read
+ * @return false if there is no text after the flag
+ */
+static bool parse_text(int argc, char ** argv, int &i, const char *&value){
+    if (++i == argc){
+        return false;
+    }
+    value = argv[i];
+    return true;
+}
+
+bool parse_options(int argc, char ** argv, abp_options &options){
+    uint64_t number;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--no-trace"){
+            options.trace = false;
+        } else if (arg == "--table-only"){
+            options.raw_trace = false;
+        } else if (arg == "--binary-trace"){
+            options.binary_trace = true;
+        } else if (arg == "--profile"){
+            options.profile = true;
+        } else if (arg == "--until-quiescent"){
+            options.until_quiescent = true;
+        } else if (arg == "--selective-repeat"){
+            options.selective_repeat = true;
+        } else if (arg == "--adaptive-timeout"){
+            options.adaptive_timeout = true;
+        } else if (arg == "--seed"){
+            if (!parse_number(argc, argv, i, options.seed)){
+                return false;
+            }
+            options.seeded = true;
+        } else if (arg == "--until-delivered" || arg == "--wall-clock" || 
+                   arg == "--checkpoint-interval" || arg == "--window"){
+            if (!parse_number(argc, argv, i, number) || number == 0){
+                return false;
+            }
+            (arg == "--until-delivered" ? options.until_delivered : 
+             arg == "--wall-clock" ? options.wall_clock : 
+             arg == "--window" ? options.window : options.checkpoint_interval) = number;
+        } else if (arg == "--checkpoint" || arg == "--restore" || 
+                   arg == "--parameters" || arg == "--delay-file" || arg == "--stats"){
+            if (!parse_text(argc, argv, i, arg == "--checkpoint" ? options.checkpoint_file : 
+                                           arg == "--restore" ? options.restore_file : 
+                                           arg == "--parameters" ? options.parameters_file : 
+                                           arg == "--delay-file" ? options.delay_file : 
+                                                                   options.stats_file)){
+                return false;
+            }
+        } else if (arg.compare(0, 2, "--") == 0 || options.input_file){
+            return false;
+        } else{
+            options.input_file = argv[i];
+        }
+    }
+    return options.input_file != nullptr && 
+           !(options.checkpoint_interval && !options.checkpoint_file) && 
+           !(options.selective_repeat && !options.window);
+}
+
+bool parse_replication_options(int argc, char ** argv, 
+                               abp_replication_options &options){
+    uint64_t number;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--seed"){
+            if (!parse_number(argc, argv, i, options.seed)){
+                return false;
+            }
+        } else if (arg == "--runs" || arg == "--threads"){
+            if (!parse_number(argc, argv, i, number) || number == 0){
+                return false;
+            }
+            (arg == "--runs" ? options.runs : options.threads) = number;
+        } else if (arg.compare(0, 2, "--") == 0 || options.input_file){
+            return false;
+        } else{
+            options.input_file = argv[i];
+        }
+    }
+    return options.input_file != nullptr;
+}
+
+bool parse_sweep_options(int argc, char ** argv, abp_sweep_options &options){
+    uint64_t number;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--grid"){
+            if (!parse_text(argc, argv, i, options.grid_file)){
+                return false;
+            }
+        } else if (arg == "--output"){
+            if (!parse_text(argc, argv, i, options.output_file)){
+                return false;
+            }
+        } else if (arg == "--seed"){
+            if (!parse_number(argc, argv, i, options.seed)){
+                return false;
+            }
+        } else if (arg == "--lhs" || arg == "--runs" || arg == "--threads"){
+            if (!parse_number(argc, argv, i, number) || number == 0){
+                return false;
+            }
+            (arg == "--lhs" ? options.lhs : 
+             arg == "--runs" ? options.runs : options.threads) = number;
+        } else if (arg.compare(0, 2, "--") == 0 || options.input_file){
+            return false;
+        } else{
+            options.input_file = argv[i];
+        }
+    }
+    return options.input_file != nullptr && options.grid_file != nullptr;
+}
+
+bool parse_flow_options(int argc, char ** argv, abp_flow_options &options){
+    uint64_t number;
+    bool flows = false;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--no-trace"){
+            options.trace = false;
+        } else if (arg == "--table-only"){
+            options.raw_trace = false;
+        } else if (arg == "--conservative"){
+            options.conservative = true;
+            options.trace = false;
+        } else if (arg == "--config"){
+            if (!parse_text(argc, argv, i, options.flows_file)){
+                return false;
+            }
+        } else if (arg == "--flows"){
+            if (!parse_number(argc, argv, i, options.flows) || options.flows == 0){
+                return false;
+            }
+            flows = true;
+        } else if (arg == "--threads" || arg == "--sync-interval"){
+            if (!parse_number(argc, argv, i, number) || number == 0){
+                return false;
+            }
+            (arg == "--threads" ? options.threads : options.sync_interval) = number;
+        } else if (arg == "--seed"){
+            if (!parse_number(argc, argv, i, options.seed)){
+                return false;
+            }
+        } else if (arg.compare(0, 2, "--") == 0 || options.input_file){
+            return false;
+        } else{
+            options.input_file = argv[i];
+        }
+    }
+    return options.input_file != nullptr && !(flows && options.flows_file) && 
+           !(options.conservative && options.threads > 1);
+}
@@ -0,0 +1,45 @@
+/** \brief Source file for the statistics of the replication driver
+ *
+ * Confidence intervals of the metrics measured over the
+ * replications of the ABP Simulator.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "../../include/top_model/abp_replications.hpp"
+
+using namespace std;
+
+/**
+ * Two sided 95% quantiles of the Student t distribution for 1 to 30
+ * degrees of freedom. Above that the normal quantile is used.
+ */
+static const double T_QUANTILES_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+confidence_interval mean_confidence_interval(const vector<double> &sample){
+    confidence_interval ci = {0, 0};
+    size_t n = sample.size();
+    if (n == 0){
+        return ci;
+    }
+    for (double x : sample){
+        ci.mean += x;
+    }
+    ci.mean /= n;
+    if (n == 1){
+        return ci;
+    }
+    double squares = 0;
+    for (double x : sample){
+        squares += (x - ci.mean) * (x - ci.mean);
+    }
+    double deviation = sqrt(squares / (n - 1));
+    double t = n - 1 <= 30 ? T_QUANTILES_95[n - 2] : 1.960;
+    ci.half_width = t * deviation / sqrt((double)n);
+    return ci;
+}
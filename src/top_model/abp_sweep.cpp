@@ -0,0 +1,172 @@
+/** \brief Source file for the parameter sweep of the ABP Simulator
+ *
+ * Reads the grid file and the parameters files, generates the
+ * points of the sweep and writes their results.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../include/top_model/abp_sweep.hpp"
+
+using namespace std;
+
+const char * const ABP_PARAMETER_NAMES[ABP_PARAMETER_COUNT] = {
+    "sender_preparation",
+    "sender_timeout",
+    "receiver_preparation",
+    "pass_probability",
+    "delay_mean",
+    "delay_stddev",
+    "delay_min",
+    "window",
+    "selective_repeat",
+    "adaptive_timeout",
+    "burst_enter",
+    "burst_exit",
+    "burst_pass",
+    "delay_distribution",
+    "delay_shape",
+    "delay_resolution",
+    "queue_capacity",
+    "bandwidth",
+    "packet_size"
+};
+
+bool valid_parameter_value(int i, double value){
+    switch (i){
+        case PASS_PROBABILITY:
+        case WINDOW_SELECTIVE_REPEAT:
+        case ADAPTIVE_TIMEOUT:
+        case BURST_ENTER:
+        case BURST_EXIT:
+        case BURST_PASS:
+            return value >= 0 && value <= 1;
+        case DELAY_DISTRIBUTION:
+            return value >= 0 && std::llround(value) < DELAY_EMPIRICAL;
+        default:
+            return value >= 0;
+    }
+}
+
+bool read_sweep_space(const char *file, 
+                      const abp_sweep_point &defaults, 
+                      abp_sweep_space &space){
+    ifstream is(file);
+    if (!is){
+        return false;
+    }
+    for (int i = 0; i < ABP_PARAMETER_COUNT; i++){
+        space[i].assign(1, defaults[i]);
+    }
+    string line, name;
+    while (getline(is, line)){
+        istringstream fields(line);
+        if (!(fields >> name) || name[0] == '#'){
+            continue;
+        }
+        int i = find(ABP_PARAMETER_NAMES, ABP_PARAMETER_NAMES + ABP_PARAMETER_COUNT, 
+                     name) - ABP_PARAMETER_NAMES;
+        if (i == ABP_PARAMETER_COUNT){
+            return false;
+        }
+        space[i].clear();
+        double value;
+        while (fields >> value){
+            if (!valid_parameter_value(i, value)){
+                return false;
+            }
+            space[i].push_back(value);
+        }
+        if (space[i].empty() || !fields.eof()){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool read_parameter_values(const char *file, abp_sweep_point &point){
+    ifstream is(file);
+    if (!is){
+        return false;
+    }
+    string line, name;
+    while (getline(is, line)){
+        istringstream fields(line);
+        if (!(fields >> name) || name[0] == '#'){
+            continue;
+        }
+        do{
+            int i = find(ABP_PARAMETER_NAMES, ABP_PARAMETER_NAMES + ABP_PARAMETER_COUNT, 
+                         name) - ABP_PARAMETER_NAMES;
+            double value;
+            if (i == ABP_PARAMETER_COUNT || !(fields >> value) || !valid_parameter_value(i, value)){
+                return false;
+            }
+            point[i] = value;
+        } while (fields >> name);
+    }
+    return true;
+}
+
+vector<abp_sweep_point> grid_points(const abp_sweep_space &space){
+    vector<abp_sweep_point> points(1);
+    for (int i = 0; i < ABP_PARAMETER_COUNT; i++){
+        vector<abp_sweep_point> expanded;
+        for (const abp_sweep_point &point : points){
+            for (double value : space[i]){
+                expanded.push_back(point);
+                expanded.back()[i] = value;
+            }
+        }
+        points.swap(expanded);
+    }
+    return points;
+}
+
+vector<abp_sweep_point> latin_hypercube_points(const abp_sweep_space &space, 
+                                               size_t count, 
+                                               random_generator &generator){
+    vector<abp_sweep_point> points(count);
+    vector<size_t> strata(count);
+    for (int i = 0; i < ABP_PARAMETER_COUNT; i++){
+        double low = *min_element(space[i].begin(), space[i].end());
+        double high = *max_element(space[i].begin(), space[i].end());
+        for (size_t k = 0; k < count; k++){
+            strata[k] = k;
+        }
+        // Fisher-Yates shuffle of the strata
+        for (size_t k = count; k > 1; k--){
+            swap(strata[k - 1], strata[generator() % k]);
+        }
+        for (size_t k = 0; k < count; k++){
+            points[k][i] = low + (high - low) * 
+                           (strata[k] + generator.uniform()) / count;
+        }
+    }
+    return points;
+}
+
+void write_sweep_csv(ostream &os, 
+                     const vector<abp_sweep_point> &points, 
+                     const vector<abp_sweep_row> &rows){
+    os << "point";
+    for (const char *name : ABP_PARAMETER_NAMES){
+        os << ',' << name;
+    }
+    os << ",delivery_time,delivery_time_ci,retransmissions,packets_lost,packets_delivered\n";
+    for (size_t p = 0; p < points.size(); p++){
+        os << p;
+        for (double value : points[p]){
+            os << ',' << value;
+        }
+        os << ',' << rows[p].delivery_time.mean 
+           << ',' << rows[p].delivery_time.half_width 
+           << ',' << rows[p].retransmissions 
+           << ',' << rows[p].packets_lost 
+           << ',' << rows[p].packets_delivered << '\n';
+    }
+}
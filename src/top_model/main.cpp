@@ -14,6 +14,8 @@
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <string>
 
 #include <cadmium/modeling/coupling.hpp>
@@ -29,6 +31,7 @@
 //updated relative paths --Syed Omar
 
 #include "../../lib/DESTimes/include/NDTime.hpp"
+#include "../../include/data_structures/tick_time.hpp"
 
 #include "../../lib/vendor/iestream.hpp"
 
@@ -38,54 +41,76 @@
 #include "../../include/atomics/sender_cadmium.hpp"
 #include "../../include/atomics/receiver_cadmium.hpp"
 #include "../../include/atomics/subnet_cadmium.hpp"
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/top_model/abp_sweep.hpp"
+#include "../../include/top_model/abp_checkpoint.hpp"
+#include "../../include/top_model/abp_options.hpp"
+#include "../../include/top_model/abp_stop.hpp"
+#include "../../include/top_model/abp_statistics.hpp"
 #include "../../include/transform_output/transform_output.hpp"
 
 //define new input and output filename and path
 
 #define ABP_OUTPUT_FILE_PATH "data/top_model/abp_output.txt"
 #define ABP_TRANSFORM_OUTPUT_FILE_PATH "data/top_model/abp_output_transform.txt"
+#define ABP_BINARY_OUTPUT_FILE_PATH "data/top_model/abp_output.bin"
 
 using namespace std;
 
 using hclock=chrono::high_resolution_clock;
+// built with -DABP_TICK_TIME the models run on the integer tick time
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
 using TIME = NDTime;
+#endif
 
 
 
 /**
- * Setting input ports for messages
+ * Creates the runner for the top model with the given logger and
+ * runs the simulation until one of the stop conditions is met,
+ * 04:00:00:000 by default, printing the elapsed times.
+ * @tparam LOGGER cadmium logger used by the runner
+ * @param model top model built by make_abp_top_model
+ * @param conditions conditions stopping the run
+ * @param start time point the measures are relative to
+ * @param reason reason the run stopped
+ * @param time time the run starts at, set to the time it was run until
+ * @param end_time set to the time the simulation ended
+ * @param checkpoint function saving the run, or nullptr
+ * @param interval simulated time between two checkpoints
+ * @return seconds taken by the run itself
  */
-struct inp_control : public cadmium::in_port<message_t> {};
-struct inp_1 : public cadmium::in_port<message_t> {};
-struct inp_2 : public cadmium::in_port<message_t> {};
+template<typename LOGGER>
+double run_simulation(const abp_top_model<TIME> &model, 
+                    const abp_stop_conditions<TIME> &conditions, 
+                    hclock::time_point start, 
+                    abp_stop_reason &reason, 
+                    TIME &time, 
+                    TIME &end_time, 
+                    const std::function<void(const TIME &)> &checkpoint, 
+                    const TIME &interval){
+    cadmium::dynamic::engine::runner<TIME, LOGGER> r(model.top, time);
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double, 
+                    std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create runner
 
-/**
- * Setting output ports for messages 
- */
-struct outp_ack : public cadmium::out_port<message_t> {};
-struct outp_1 : public cadmium::out_port<message_t> {};
-struct outp_2 : public cadmium::out_port<message_t> {};
-struct outp_pack : public cadmium::out_port<message_t> {};
+    cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
+
+    cout << "Simulation starts" << endl;
 
+    auto run_start = hclock::now();
+    reason = run_until_stopped<TIME>(r, model.sender, conditions, time, end_time, 
+                                     checkpoint, interval);
+    auto run_end = hclock::now();
 
-/**
- * This is application generator class takes file path
- * parameter and waits for input
- * @tParam message T
- */
-template<typename T>
-class ApplicationGen : public iestream_input<message_t,T>{
-    public:
-    ApplicationGen() = default;
-    /**
-     * A parameterized contructor for class application generator 
-     * takes input path of the file that containes the input for
-     * the application to run
-     * @param file_path
-     */
-    ApplicationGen(const char* file_path) : 
-        iestream_input<message_t,T>(file_path) {}
-};
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, 
+                   std::ratio<1>>>(hclock::now() - start).count();
+                   ///< Run-time of simulation
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+    return std::chrono::duration_cast<std::chrono::duration<double, 
+           std::ratio<1>>>(run_end - run_start).count();
+}
 
 
 /**\brief  Main function
@@ -99,15 +124,41 @@ class ApplicationGen : public iestream_input<message_t,T>{
 
  * Reads input from file, runs ABP Simulator, then prints output to file
  * Prints information about the simulator's time metric
+ * The log is transformed to a table while the simulation runs.
+ * With --table-only only the table is written and with --no-trace
+ * no output file is written, only the results are printed
+ * With --profile the time spent in each function of each atomic
+ * model is reported after the results
+ * The run stops at 04:00:00:000, or with --until-quiescent once every
+ * model is passive, or earlier with --until-delivered once the sender
+ * delivered the packets asked or with --wall-clock once the seconds
+ * given are spent, and the reason it stopped is printed
+ * With --checkpoint the run is saved when it stops, and every
+ * --checkpoint-interval seconds of simulated time, and with
+ * --restore it is resumed from a saved run
+ * With --window the sender sends a window of packets ahead of their
+ * acknowledgements, Go-Back-N or with --selective-repeat
+ * With --adaptive-timeout the timeout of the sender follows the round
+ * trip times it measures
+ * With --parameters the atomic models take the parameters of a file,
+ * such as the loss model and the delay distribution of the subnets,
+ * and with --delay-file the delays are drawn from measured samples
+ * With --stats the statistics counted by the atomic models are also
+ * written to a JSON or CSV file, so a run with --no-trace needs no log
  * @param argc Integer argument - count of the command line arguments
  * @param argv Argument vector - the command line arguments
  */
 int main(int argc, char ** argv){
 
-    if (argc < 2){
+    abp_options options;
+    if (!parse_options(argc, argv, options)){
         cout << "you are using this program with wrong parameters."
         "The program should be invoked as follow:";
-        cout << argv[0] << " path to the input file " << endl;
+        cout << argv[0] << " path to the input file [--no-trace | --table-only | --binary-trace] [--seed N] [--profile]"
+                           " [--until-quiescent] [--until-delivered N] [--wall-clock N]"
+                           " [--checkpoint FILE [--checkpoint-interval N]] [--restore FILE]"
+                           " [--window N [--selective-repeat]] [--adaptive-timeout]"
+                           " [--parameters FILE] [--delay-file FILE] [--stats FILE]" << endl;
         return 1; 
     }
 
@@ -118,18 +169,20 @@ int main(int argc, char ** argv){
     /**
      * To generate messages and operation logs which are being passed
      * during execution time of this application and storing them
-     * in the abp_output file as indicated out_data.
+     * in the abp_output_transform file as a table, and in the
+     * abp_output file as they are unless only the table is asked.
+     * It is only opened when the run is traced.
      */
-    static std::ofstream out_data(output_file);
+    static transform_sink out_sink;
 
     /**
-     * This is a common sink provider structure 
-     * which calls the ostream that is the output stream
-     * and it return data stored in the file
+     * This is a sink provider structure which returns the
+     * stream of the transform sink, so the log is transformed
+     * as the loggers write it
      */
-    struct oss_sink_provider{
+    struct transform_sink_provider{
         static std::ostream& sink(){          
-            return out_data;
+            return out_sink.stream();
         }
     };
 
@@ -140,25 +193,25 @@ int main(int argc, char ** argv){
      */
     using info = cadmium::logger::logger<cadmium::logger::logger_info, 
                  cadmium::dynamic::logger::formatter<TIME>, 
-                 oss_sink_provider>;
+                 transform_sink_provider>;
     using debug = cadmium::logger::logger<cadmium::logger::logger_debug, 
                   cadmium::dynamic::logger::formatter<TIME>, 
-                  oss_sink_provider>;
+                  transform_sink_provider>;
     using state = cadmium::logger::logger<cadmium::logger::logger_state, 
                   cadmium::dynamic::logger::formatter<TIME>, 
-                  oss_sink_provider>;
+                  transform_sink_provider>;
     using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages, 
                          cadmium::dynamic::logger::formatter<TIME>, 
-                         oss_sink_provider>;
+                         transform_sink_provider>;
     using routing = cadmium::logger::logger<cadmium::logger::logger_message_routing, 
                     cadmium::dynamic::logger::formatter<TIME>, 
-                    oss_sink_provider>;
+                    transform_sink_provider>;
     using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time, 
                         cadmium::dynamic::logger::formatter<TIME>, 
-                        oss_sink_provider>;
+                        transform_sink_provider>;
     using local_time = cadmium::logger::logger<cadmium::logger::logger_local_time, 
                        cadmium::dynamic::logger::formatter<TIME>, 
-                       oss_sink_provider>;
+                       transform_sink_provider>;
     using log_all = cadmium::logger::multilogger<info, 
                                                  debug, 
                                                  state, 
@@ -171,201 +224,67 @@ int main(int argc, char ** argv){
 
 
     /**
-     * Assign first argument value to input data control for application
-     * generator file for execution and
-     * runs the execution for number of input times 
-     */
-    string input_data_control = argv[1];
-    const char * i_input_data_control = input_data_control.c_str();
-
-    /**
-     * Initialized generator which has output file path, Time and 
-     * with given input generates the output
-     */
-    std::shared_ptr<cadmium::dynamic::modeling::model> generator_con = 
-                    cadmium::dynamic::translate::make_dynamic_atomic_model
-                    <ApplicationGen, 
-                     TIME, 
-                     const char* >("generator_con" , 
-                                   std::move(i_input_data_control)
-                                   );
-
-
-    /**
-     * Identify output data which has been sent from sender1
-     */
-    std::shared_ptr<cadmium::dynamic::modeling::model> sender1 = 
-                    cadmium::dynamic::translate::make_dynamic_atomic_model
-                    <Sender,
-                     TIME>("sender1"
-                           );
-
-
-    /**
-     * Identify output data which has been receoved from receiver1
-     */
-    std::shared_ptr<cadmium::dynamic::modeling::model> receiver1 = 
-                    cadmium::dynamic::translate::make_dynamic_atomic_model
-                    <Receiver, 
-                     TIME>("receiver1"
-                           );
-
-    /**
-     * Identify output data which has been receoved from subnet1 and subnet 2
-     */
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet1 = 
-                    cadmium::dynamic::translate::make_dynamic_atomic_model
-                    <Subnet, 
-                     TIME>("subnet1"
-                           );
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet2 = 
-                    cadmium::dynamic::translate::make_dynamic_atomic_model
-                    <Subnet, 
-                     TIME>("subnet2"
-                           );
-
-    /**
-     * Store values of operations of network input and output ports
-     * which have been performed for each time frame and
-     * then store in output file
-     */
-    cadmium::dynamic::modeling::Ports iports_Network = {
-        typeid(inp_1),
-        typeid(inp_2)
-    };
-    cadmium::dynamic::modeling::Ports oports_Network = {
-        typeid(outp_1),
-        typeid(outp_2)
-    };
-    cadmium::dynamic::modeling::Models submodels_Network = {
-        subnet1, 
-        subnet2
-    };
-    cadmium::dynamic::modeling::EICs eics_Network = {
-        cadmium::dynamic::translate::make_EIC<inp_1, 
-                                              subnet_defs::in>("subnet1"
-                                                               ),
-        cadmium::dynamic::translate::make_EIC<inp_2, 
-                                              subnet_defs::in>("subnet2"
-                                                               )
-    };
-    cadmium::dynamic::modeling::EOCs eocs_Network = {
-        cadmium::dynamic::translate::make_EOC<subnet_defs::out,
-                                              outp_1>("subnet1"
-                                                      ),
-        cadmium::dynamic::translate::make_EOC<subnet_defs::out,
-                                              outp_2>("subnet2"
-                                                      )
-    };
-    cadmium::dynamic::modeling::ICs ics_Network = {};
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> NETWORK = 
-    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>("Network", 
-                                                                submodels_Network, 
-                                                                iports_Network, 
-                                                                oports_Network, 
-                                                                eics_Network, 
-                                                                eocs_Network, 
-                                                                ics_Network 
-                                                                );
-
-
-    /**
-     * Store values of operations of input control and
-     * output packet acknowledgement of ABP simulator input/output ports
-     * which have been performed for each time frame and
-     * then store in output file
+     * Build the top model from the input data control file given
+     * as the first argument, seeding the subnets with the given seed,
+     * with the window sender and receiver if a window is given, with
+     * an adaptive timeout if asked, with the parameters of the
+     * parameters file and the delays of the delay file if given, with
+     * its atomic models profiled if asked, and resumable if the run
+     * is checkpointed or restored
      */
-    cadmium::dynamic::modeling::Ports iports_ABPSimulator = {
-        typeid(inp_control)
-    };
-    cadmium::dynamic::modeling::Ports oports_ABPSimulator = {
-        typeid(outp_ack),
-        typeid(outp_pack)
-    };
-    cadmium::dynamic::modeling::Models submodels_ABPSimulator = {
-        sender1, 
-        receiver1,
-        NETWORK
-    };
-    cadmium::dynamic::modeling::EICs eics_ABPSimulator = {
-        cadmium::dynamic::translate::make_EIC<inp_control, 
-                                              sender_defs::controlIn>("sender1"
-                                                                      )
-    };
-    cadmium::dynamic::modeling::EOCs eocs_ABPSimulator = {
-        cadmium::dynamic::translate::make_EOC<sender_defs::packetSentOut,
-                                              outp_pack>("sender1"
-                                                         ),
-        cadmium::dynamic::translate::make_EOC<sender_defs::ackReceivedOut,
-                                              outp_ack>("sender1"
-                                                        )
-    };
-    cadmium::dynamic::modeling::ICs ics_ABPSimulator = {
-        cadmium::dynamic::translate::make_IC<sender_defs::dataOut, 
-                                             inp_1>("sender1",
-                                                    "Network"
-                                                    ),
-        cadmium::dynamic::translate::make_IC<outp_2, 
-                                             sender_defs::ackIn>("Network",
-                                                                 "sender1"),
-        cadmium::dynamic::translate::make_IC<receiver_defs::out, 
-                                             inp_2>("receiver1",
-                                                    "Network"
-                                                    ),
-        cadmium::dynamic::translate::make_IC<outp_1, 
-                                             receiver_defs::in>("Network",
-                                                                "receiver1"
-                                                                )
-    };
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> ABPSimulator = 
-    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>("ABPSimulator", 
-                                                                submodels_ABPSimulator, 
-                                                                iports_ABPSimulator, 
-                                                                oports_ABPSimulator, 
-                                                                eics_ABPSimulator, 
-                                                                eocs_ABPSimulator, 
-                                                                ics_ABPSimulator 
-                                                                );
-
+    abp_parameters<TIME> parameters;
+    parameters.window = int64_t(options.window);
+    parameters.mode = options.selective_repeat ? SELECTIVE_REPEAT : GO_BACK_N;
+    parameters.adaptive_timeout = options.adaptive_timeout;
+    if (options.parameters_file){
+        abp_sweep_point point = to_sweep_point(parameters);
+        if (!read_parameter_values(options.parameters_file, point)){
+            cout << "The parameters file " << options.parameters_file << " is not valid" << endl;
+            return 1;
+        }
+        parameters = to_parameters<TIME>(point);
+    }
+    if (options.delay_file){
+        std::vector<double> samples;
+        if (!read_delay_samples(options.delay_file, samples)){
+            cout << "The delay file " << options.delay_file << " is not valid" << endl;
+            return 1;
+        }
+        parameters.delay = DELAY_EMPIRICAL;
+        parameters.delay_samples = std::make_shared<const std::vector<double>>(std::move(samples));
+    }
+    abp_top_model<TIME> model = make_abp_top_model<TIME>(options.input_file, 
+                                                         options.seed, 
+                                                         parameters, 
+                                                         options.profile, 
+                                                         options.checkpoint_file || 
+                                                         options.restore_file);
 
     /**
-     * Store values of top model operations
-     * which have been performed for each time frame and
-     * then store in output file
+     * Restore the run saved, the runner is then created at the time
+     * it was saved at. With --seed its subnets draw from a new seed.
      */
-    cadmium::dynamic::modeling::Ports iports_TOP = {};
-    cadmium::dynamic::modeling::Ports oports_TOP = {
-        typeid(outp_pack),
-        typeid(outp_ack)
-    };
-    cadmium::dynamic::modeling::Models submodels_TOP = {
-        generator_con, 
-        ABPSimulator
-    };
-    cadmium::dynamic::modeling::EICs eics_TOP = {};
-    cadmium::dynamic::modeling::EOCs eocs_TOP = {
-        cadmium::dynamic::translate::make_EOC<outp_pack,
-                                              outp_pack>("ABPSimulator"
-                                                         ),
-        cadmium::dynamic::translate::make_EOC<outp_pack,
-                                              outp_ack>("ABPSimulator"
-                                                       )
-    };
-    cadmium::dynamic::modeling::ICs ics_TOP = {
-        cadmium::dynamic::translate::make_IC<iestream_input_defs<message_t>::out,
-                                                                 inp_control>("generator_con",
-                                                                              "ABPSimulator"
-                                                                              )
-    };
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> TOP = 
-    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>( "TOP", 
-                                                                submodels_TOP, 
-                                                                iports_TOP, 
-                                                                oports_TOP, 
-                                                                eics_TOP, 
-                                                                eocs_TOP, 
-                                                                ics_TOP 
-                                                                );
+    TIME time = TIME();
+    if (options.restore_file){
+        if (!restore_abp_checkpoint(options.restore_file, model, time)){
+            cout << "The checkpoint " << options.restore_file 
+                 << " is not a run of this input file and protocol" << endl;
+            return 1;
+        }
+        if (options.seeded){
+            reseed_abp_subnets(model, options.seed);
+        }
+        cout << "Restored at " << time << endl;
+    }
+    bool saved = true;
+    std::function<void(const TIME &)> checkpoint = nullptr;
+    TIME interval = std::numeric_limits<TIME>::infinity();
+    if (options.checkpoint_file && options.checkpoint_interval){
+        checkpoint = [&](const TIME &t){
+            saved = save_abp_checkpoint(options.checkpoint_file, model, t) && saved;
+        };
+        interval = time_from_milliseconds<TIME>(int64_t(options.checkpoint_interval) * 1000);
+    }
 
     /**
      * Create a model and measure elapsed time form creations in 
@@ -377,26 +296,50 @@ int main(int argc, char ** argv){
     auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double, 
                     std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create model
     cout << "Model Created. Elapsed time: " << elapsed1 << "sec" << endl;
-    
-    cadmium::dynamic::engine::runner<NDTime, logger_top> r(TOP, {0});
-    elapsed1 = std::chrono::duration_cast<std::chrono::duration<double, 
-               std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create runner
-
-    cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
-
-    cout << "Simulation starts" << endl;
 
-    r.run_until(NDTime("04:00:00:000"));
-
-    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, 
-                   std::ratio<1>>>(hclock::now() - start).count();
-                   ///< Run-time of simulation
-    cout << "Simulation took:" << elapsed << "sec" << endl;
+    abp_stop_conditions<TIME> conditions;
+    if (options.until_quiescent){
+        conditions.until = std::numeric_limits<TIME>::infinity();
+    }
+    conditions.packets_delivered = options.until_delivered;
+    conditions.wall_clock = options.wall_clock;
+
+    double run_seconds;
+    abp_stop_reason reason;
+    TIME end_time;
+    if (options.trace){
+        if (options.binary_trace){
+            out_sink.open_binary(ABP_BINARY_OUTPUT_FILE_PATH);
+        } else{
+            out_sink.open(transform_output_file, 
+                          options.raw_trace ? output_file : nullptr);
+        }
+        run_seconds = run_simulation<logger_top>(model, conditions, start, reason, 
+                                                 time, end_time, checkpoint, interval);
+        out_sink.close();
+    } else{
+        run_seconds = run_simulation<cadmium::logger::not_logger>(model, conditions, start, reason, 
+                                                                  time, end_time, checkpoint, 
+                                                                  interval);
+    }
+    if (options.checkpoint_file){
+        saved = save_abp_checkpoint(options.checkpoint_file, model, time) && saved;
+        if (saved){
+            cout << "Checkpoint saved at " << time << endl;
+        } else{
+            cout << "The checkpoint " << options.checkpoint_file << " cannot be written" << endl;
+        }
+    }
 
-    /**
-     * transform the output file generated by simulator to readable text
-     */
-    transform_output(output_file,transform_output_file);
+    abp_results<TIME> results = collect_abp_results(model, end_time);
+    print_abp_results(cout, results);
+    cout << "Stop reason: " << stop_reason_name(reason) << endl;
+    if (options.stats_file && !write_abp_statistics(options.stats_file, results, reason)){
+        cout << "The statistics file " << options.stats_file << " cannot be written" << endl;
+    }
+    if (options.profile){
+        profile_registry::instance().report(cout, run_seconds);
+    }
 
     return 0;
 }
@@ -0,0 +1,242 @@
+/** \brief Main source file of the multi-flow simulator
+ *
+ * Runs many independent ABP flows in one simulation, each one a
+ * sender and a receiver over their own network, all started by the
+ * same control input. The flows are given by a count or by a flows
+ * file. Prints the memory taken by each flow and the results of all
+ * the flows together.
+ *
+ * With more than one thread the flows, which never exchange messages,
+ * are split in a partition per thread, each with its own copy of the
+ * control generator, and run by the partitioned runner. The log is
+ * the same as the one of the single runner.
+ *
+ * With --conservative the endpoints and the network of the flows are
+ * instead run as two logical processes, each on its own thread, kept
+ * in step by the lookahead of the subnets, without a log.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_conservative.hpp"
+#include "../../include/top_model/abp_flows.hpp"
+#include "../../include/top_model/abp_options.hpp"
+#include "../../include/parallel/partitioned_runner.hpp"
+#include "../../include/transform_output/transform_output.hpp"
+
+//define output filename and path
+
+#define ABP_FLOWS_OUTPUT_FILE_PATH "data/top_model/abp_flows_output.txt"
+#define ABP_FLOWS_TRANSFORM_OUTPUT_FILE_PATH "data/top_model/abp_flows_output_transform.txt"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Creates the runner for the top model, or the partitioned runner of
+ * the partitions, with the given logger and runs the simulation until
+ * 04:00:00:000, printing the elapsed time.
+ * @tparam LOGGER cadmium logger used by the runner
+ * @param partitions top models built by make_abp_flows_model
+ * @param options options of the run
+ * @param trace stream the log of the partitions is merged to, or nullptr
+ * @param start time point the measures are relative to
+ */
+template<typename LOGGER>
+void run_simulation(const vector<abp_flows_model<TIME>> &partitions,
+                    const abp_flow_options &options,
+                    std::ostream *trace,
+                    hclock::time_point start){
+    if (partitions.size() == 1){
+        cadmium::dynamic::engine::runner<TIME, LOGGER> r(partitions[0].top, {0});
+        auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
+                        std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create runner
+        cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
+
+        r.run_until(TIME("04:00:00:000"));
+    } else{
+        vector<typename partitioned_runner<TIME, LOGGER>::top_model> tops;
+        for (const abp_flows_model<TIME> &partition : partitions){
+            tops.push_back(partition.top);
+        }
+        partitioned_runner<TIME, LOGGER> r(tops, {0}, options.threads, "generator_con", trace);
+        auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
+                        std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create runner
+        cout << "Runners of " << partitions.size() << " partitions created. Elapsed time: "
+             << elapsed1 << "sec" << endl;
+
+        r.run_until(TIME("04:00:00:000"), seconds_to_time<TIME>(options.sync_interval));
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+                   std::ratio<1>>>(hclock::now() - start).count();
+                   ///< Run-time of simulation
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+}
+
+/**
+ * Builds the flows as the two logical processes of the conservative
+ * run, runs them until 04:00:00:000 and prints the results.
+ * @param options options of the run
+ * @param groups groups of flows
+ * @param flows number of flows
+ * @param start time point the measures are relative to
+ * @return exit code of the program
+ */
+int run_conservative(const abp_flow_options &options,
+                     const vector<abp_flow_group> &groups,
+                     uint64_t flows,
+                     hclock::time_point start){
+    size_t memory_before = resident_memory();
+    abp_conservative_model<TIME> model;
+    try{
+        model = make_abp_conservative_model<TIME>(options.input_file, groups, options.seed);
+    } catch (const invalid_argument &error){
+        cout << "--conservative needs subnets with a delay_min of at least 1 second: "
+             << error.what() << endl;
+        return 1;
+    }
+    size_t memory_after = resident_memory();
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
+                    std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create model
+    cout << "Logical processes of " << flows << " flows created. Elapsed time: "
+         << elapsed1 << "sec" << endl;
+    if (memory_after > memory_before){
+        cout << "Memory per flow: " << (memory_after - memory_before) / flows << " bytes" << endl;
+    }
+
+    uint64_t windows = run_abp_conservative(model, TIME("04:00:00:000"));
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+                   std::ratio<1>>>(hclock::now() - start).count();
+                   ///< Run-time of simulation
+    cout << "Simulation took:" << elapsed << "sec in " << windows << " windows" << endl;
+
+    abp_flows_model<TIME> results;
+    results.flows = model.flows;
+    cout << "Flows: " << flows << endl;
+    print_abp_results(cout, collect_abp_flows_results(results, TIME("04:00:00:000")));
+    return 0;
+}
+
+/**\brief  Main function
+ *
+ * Builds the flows from the count or the flows file, runs them
+ * writing the log of all of them unless --no-trace is given, and
+ * prints the memory per flow and the results of all the flows.
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    abp_flow_options options;
+    if (!parse_flow_options(argc, argv, options)){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " path to the input file [--flows N | --config FILE] [--no-trace | --table-only] [--seed N]"
+                           " [--threads N [--sync-interval N] | --conservative]" << endl;
+        return 1;
+    }
+
+    /**
+     * The groups of flows, from the flows file or a single
+     * group of flows with the default parameters
+     */
+    abp_sweep_point defaults = to_sweep_point(abp_parameters<TIME>());
+    vector<abp_flow_group> groups;
+    if (options.flows_file){
+        if (!read_flow_groups(options.flows_file, defaults, groups)){
+            cout << options.flows_file << " is not a valid flows file" << endl;
+            return 1;
+        }
+    } else{
+        groups.push_back({options.flows, defaults});
+    }
+
+    /**
+     * The log of all the flows is transformed to a table while
+     * the simulation runs, as the simulator does for one flow
+     */
+    static transform_sink out_sink;
+    struct transform_sink_provider{
+        static std::ostream& sink(){
+            std::ostream *partition = partition_stream();
+            return partition ? *partition : out_sink.stream();
+        }
+    };
+    using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages,
+                         cadmium::dynamic::logger::formatter<TIME>,
+                         transform_sink_provider>;
+    using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time,
+                        cadmium::dynamic::logger::formatter<TIME>,
+                        transform_sink_provider>;
+    using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+
+    auto start = hclock::now();
+    uint64_t flows = 0;
+    for (const abp_flow_group &group : groups){
+        flows += group.flows;
+    }
+    if (options.conservative){
+        return run_conservative(options, groups, flows, start);
+    }
+    uint64_t partition_count = min(options.threads, flows);
+
+    /**
+     * The flows of the model, in a partition per thread
+     */
+    size_t memory_before = resident_memory();
+    vector<abp_flows_model<TIME>> partitions;
+    for (uint64_t p = 0; p < partition_count; p++){
+        uint64_t first = 1 + p * flows / partition_count;
+        uint64_t last = 1 + (p + 1) * flows / partition_count;
+        partitions.push_back(make_abp_flows_model<TIME>(options.input_file,
+                                                        groups,
+                                                        options.seed,
+                                                        false,
+                                                        first,
+                                                        last - first));
+    }
+    size_t memory_after = resident_memory();
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
+                    std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create model
+    cout << "Model of " << flows << " flows created. Elapsed time: " << elapsed1 << "sec" << endl;
+    if (memory_after > memory_before){
+        cout << "Memory per flow: " << (memory_after - memory_before) / flows << " bytes" << endl;
+    }
+
+    if (options.trace){
+        out_sink.open(ABP_FLOWS_TRANSFORM_OUTPUT_FILE_PATH,
+                      options.raw_trace ? ABP_FLOWS_OUTPUT_FILE_PATH : nullptr);
+        run_simulation<logger_top>(partitions, options, &out_sink.stream(), start);
+        out_sink.close();
+    } else{
+        run_simulation<cadmium::logger::not_logger>(partitions, options, nullptr, start);
+    }
+    size_t memory_run = resident_memory();
+    if (memory_run > memory_before){
+        cout << "Memory per flow after the run: "
+             << (memory_run - memory_before) / flows << " bytes" << endl;
+    }
+
+    abp_flows_model<TIME> model;
+    for (const abp_flows_model<TIME> &partition : partitions){
+        model.flows.insert(model.flows.end(), partition.flows.begin(), partition.flows.end());
+    }
+    cout << "Flows: " << flows << endl;
+    print_abp_results(cout, collect_abp_flows_results(model, TIME("04:00:00:000")));
+
+    return 0;
+}
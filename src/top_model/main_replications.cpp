@@ -0,0 +1,93 @@
+/** \brief Main source file of the replication driver
+ *
+ * Runs many independent replications of the ABP Simulator on
+ * the same input file, each one with its own seed, spread over
+ * a pool of threads. Prints the mean and the 95% confidence
+ * interval of the metrics of the runs.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/top_model/abp_options.hpp"
+#include "../../include/top_model/abp_replications.hpp"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Prints one metric as mean +- half width of its confidence interval
+ * @param name name of the metric
+ * @param sample value of the metric in each replication
+ */
+void print_metric(const char *name, const vector<double> &sample){
+    confidence_interval ci = mean_confidence_interval(sample);
+    cout << left << setw(22) << name << right << setw(12) << ci.mean 
+         << " +- " << ci.half_width << endl;
+}
+
+/**\brief  Main function
+ * 
+ * Runs the replications and prints the delivery time, the
+ * retransmissions, the packets lost and the packets delivered.
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    abp_replication_options options;
+    if (!parse_replication_options(argc, argv, options)){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " path to the input file [--runs N] [--threads N] [--seed N]" << endl;
+        return 1; 
+    }
+    unsigned int threads = options.threads;
+    if (threads == 0){
+        threads = max(thread::hardware_concurrency(), 1u);
+    }
+
+    auto start = hclock::now();
+    vector<abp_results<TIME>> results = run_replications<TIME>(options.input_file, 
+                                                               options.runs, 
+                                                               threads, 
+                                                               options.seed, 
+                                                               abp_parameters<TIME>(), 
+                                                               TIME("04:00:00:000"));
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, 
+                   std::ratio<1>>>(hclock::now() - start).count();
+
+    vector<double> delivery_time, retransmissions, lost, delivered;
+    latency_histogram latency, packet_retransmissions;
+    for (const abp_results<TIME> &run : results){
+        latency.merge(run.latency);
+        packet_retransmissions.merge(run.packet_retransmissions);
+        delivery_time.push_back(time_to_seconds(run.last_delivery_time));
+        retransmissions.push_back(run.retransmissions);
+        lost.push_back(run.packets_lost);
+        delivered.push_back(run.packets_delivered);
+    }
+
+    cout << "Replications: " << options.runs << " on " << threads 
+         << " threads, seeds " << options.seed << " to " 
+         << options.seed + options.runs - 1 << endl;
+    cout << "Mean and 95% confidence interval:" << endl;
+    print_metric("Delivery time (sec)", delivery_time);
+    print_metric("Retransmissions", retransmissions);
+    print_metric("Packets lost", lost);
+    print_metric("Packets delivered", delivered);
+    cout << "Packets of all the replications:" << endl;
+    print_histogram(cout, "Packet latency (ms)", latency);
+    print_histogram(cout, "Retransmissions per packet", packet_retransmissions);
+    cout << "Replications took:" << elapsed << "sec" << endl;
+    return 0;
+}
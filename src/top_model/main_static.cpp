@@ -0,0 +1,135 @@
+/** \brief Main source file of the static ABP Simulator
+ * 
+ * Runs the ABP simulation on the static coupled models defined in
+ * abp_static_top_model.hpp with the static cadmium engine.
+ * It takes the same input file and flags and writes the same
+ * output files as the dynamic ABP Simulator.
+ */
+
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+
+#include <cadmium/modeling/coupled_model.hpp>
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/engine/pdevs_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_static_top_model.hpp"
+#include "../../include/top_model/abp_options.hpp"
+#include "../../include/transform_output/transform_output.hpp"
+
+//define new input and output filename and path
+
+#define ABP_OUTPUT_FILE_PATH "data/top_model/abp_output.txt"
+#define ABP_TRANSFORM_OUTPUT_FILE_PATH "data/top_model/abp_output_transform.txt"
+#define ABP_BINARY_OUTPUT_FILE_PATH "data/top_model/abp_output.bin"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+
+/**
+ * Creates the static runner for the top model with the given logger
+ * and runs the simulation until 04:00:00:000, printing the elapsed times.
+ * @tparam LOGGER cadmium logger used by the runner
+ * @param start time point the measures are relative to
+ */
+template<typename LOGGER>
+void run_simulation(hclock::time_point start){
+    cadmium::engine::runner<TIME, TOP, LOGGER> r(TIME({0}));
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double, 
+                    std::ratio<1>>>(hclock::now() - start).count(); ///< Run-time to create runner
+
+    cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
+
+    cout << "Simulation starts" << endl;
+
+    r.run_until(TIME("04:00:00:000"));
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, 
+                   std::ratio<1>>>(hclock::now() - start).count();
+                   ///< Run-time of simulation
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+}
+
+
+/**\brief  Main function
+ * 
+ * Reads input from file, runs the static ABP Simulator, then prints
+ * output to file while the simulation runs.
+ * Prints information about the simulator's time metric
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    abp_options options;
+    if (!parse_options(argc, argv, options)){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " path to the input file [--no-trace | --table-only | --binary-trace] [--seed N]" << endl;
+        return 1; 
+    }
+
+    auto start = hclock::now(); //to measure simulation execution time
+    const char *output_file = ABP_OUTPUT_FILE_PATH;
+    const char *transform_output_file = ABP_TRANSFORM_OUTPUT_FILE_PATH;
+
+    /**
+     * Log of the simulation, transformed to a table while it is written
+     */
+    static transform_sink out_sink;
+
+    /**
+     * This is a sink provider structure which returns the
+     * stream of the transform sink
+     */
+    struct transform_sink_provider{
+        static std::ostream& sink(){          
+            return out_sink.stream();
+        }
+    };
+
+    /**
+     * Loggers of the static engine, logging the same sources
+     * as the dynamic ABP Simulator
+     */
+    using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages, 
+                         cadmium::logger::verbatim_formatter, 
+                         transform_sink_provider>;
+    using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time, 
+                        cadmium::logger::verbatim_formatter, 
+                        transform_sink_provider>;
+    using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+
+    /**
+     * The static generator is built by the runner with its default
+     * constructor, so the input file and the seed of the subnets
+     * are given to them beforehand
+     */
+    abp_static_input_file() = options.input_file;
+    abp_static_seed() = options.seed;
+
+    if (options.trace){
+        if (options.binary_trace){
+            out_sink.open_binary(ABP_BINARY_OUTPUT_FILE_PATH);
+        } else{
+            out_sink.open(transform_output_file, 
+                          options.raw_trace ? output_file : nullptr);
+        }
+        run_simulation<logger_top>(start);
+        out_sink.close();
+    } else{
+        run_simulation<cadmium::logger::not_logger>(start);
+    }
+
+    return 0;
+}
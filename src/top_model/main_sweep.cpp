@@ -0,0 +1,87 @@
+/** \brief Main source file of the parameter sweep
+ *
+ * Runs the ABP Simulator at every point of a grid of the parameters
+ * of the atomic models, or at a Latin hypercube sample of their
+ * ranges, with several replications per point. The points are
+ * spread over a pool of threads with work stealing and the results
+ * are written as CSV, one row per point.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_top_model.hpp"
+#include "../../include/top_model/abp_options.hpp"
+#include "../../include/top_model/abp_sweep.hpp"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**\brief  Main function
+ * 
+ * Reads the grid file, runs the sweep and writes its results.
+ * @param argc Integer argument - count of the command line arguments
+ * @param argv Argument vector - the command line arguments
+ */
+int main(int argc, char ** argv){
+
+    abp_sweep_options options;
+    if (!parse_sweep_options(argc, argv, options)){
+        cout << "you are using this program with wrong parameters."
+        "The program should be invoked as follow:";
+        cout << argv[0] << " path to the input file --grid path to the grid file"
+        " [--lhs N] [--output FILE] [--runs N] [--threads N] [--seed N]" << endl;
+        return 1; 
+    }
+    unsigned int threads = options.threads;
+    if (threads == 0){
+        threads = max(thread::hardware_concurrency(), 1u);
+    }
+
+    abp_sweep_space space;
+    if (!read_sweep_space(options.grid_file, 
+                          to_sweep_point(abp_parameters<TIME>()), 
+                          space)){
+        cout << "the grid file " << options.grid_file << " is not valid" << endl;
+        return 1;
+    }
+    vector<abp_sweep_point> points;
+    if (options.lhs > 0){
+        // stream 2 of the seed, the subnets use the streams 0 and 1
+        random_generator generator(options.seed, 2);
+        points = latin_hypercube_points(space, options.lhs, generator);
+    } else{
+        points = grid_points(space);
+    }
+
+    ofstream os(options.output_file);
+    if (!os){
+        cout << "the output file " << options.output_file << " cannot be written" << endl;
+        return 1;
+    }
+
+    auto start = hclock::now();
+    vector<abp_sweep_row> rows = run_sweep<TIME>(options.input_file, 
+                                                 points, 
+                                                 options.runs, 
+                                                 threads, 
+                                                 options.seed, 
+                                                 TIME("04:00:00:000"));
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, 
+                   std::ratio<1>>>(hclock::now() - start).count();
+
+    write_sweep_csv(os, points, rows);
+    cout << "Points: " << points.size() << " with " << options.runs 
+         << " replications each on " << threads << " threads" << endl;
+    cout << "Results written to " << options.output_file << endl;
+    cout << "Sweep took:" << elapsed << "sec" << endl;
+    return 0;
+}
@@ -0,0 +1,374 @@
+/** \brief Binary trace source file
+ *
+ *  Writes the simulator log as a binary trace while the simulation
+ *  runs, and decodes a binary trace into the log and its table.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+#include "../../include/data_structures/message.hpp"
+#include "../../include/transform_output/binary_trace.hpp"
+#include "../../include/transform_output/transform_output.hpp"
+
+using namespace std;
+
+/**
+ * Records kept before they are written to the file
+ */
+#define BINARY_TRACE_BLOCK_RECORDS 4096
+
+/**
+ * Text following the ports of an output line
+ */
+static const char GENERATED_BY[] = "] generated by model ";
+
+/**
+ * Writes a time in milliseconds as HH:MM:SS:mmm
+ * @param ms time in milliseconds
+ * @return the time as text
+ */
+static string time_text(int64_t ms) {
+	char text[32];
+	snprintf(text, sizeof(text), "%02lld:%02lld:%02lld:%03lld", (long long)(ms / 3600000),
+	         (long long)(ms / 60000 % 60), (long long)(ms / 1000 % 60), (long long)(ms % 1000));
+	return text;
+}
+
+/**
+ * Writes a message as packet_num[:alt_bit[:payload_length]], as
+ * the operator << of message_t does
+ * @param msg message
+ * @return the message as text
+ */
+static string message_text(const message_t &msg) {
+	char text[48];
+	int n = snprintf(text, sizeof(text), "%lld", (long long)msg.packet_num);
+	if (msg.alt_bit != message_t::NO_BIT || msg.payload_length != 0) {
+		n += snprintf(text + n, sizeof(text) - n, ":%d", (int)msg.alt_bit);
+	}
+	if (msg.payload_length != 0) {
+		snprintf(text + n, sizeof(text) - n, ":%u", (unsigned)msg.payload_length);
+	}
+	return text;
+}
+
+/**
+ * Reads a time line HH:MM:SS:mmm
+ * @param line the line
+ * @param ms time in milliseconds
+ * @return false if the line is not a time written this way
+ */
+static bool parse_time_line(const string &line, int64_t &ms) {
+	long long h, m, s, mil;
+	int end = 0;
+	if (sscanf(line.c_str(), "%lld:%lld:%lld:%lld%n", &h, &m, &s, &mil, &end) != 4 ||
+	    end != (int)line.size()) {
+		return false;
+	}
+	ms = ((h * 60 + m) * 60 + s) * 1000 + mil;
+	return time_text(ms) == line;
+}
+
+bool binary_trace_streambuf::open(const char *file_name) {
+	close();
+	file.open(file_name, ios::binary | ios::trunc);
+	if (!file) {
+		return false;
+	}
+	char header[BINARY_TRACE_HEADER_SIZE] = {};
+	file.write(header, sizeof(header));
+	records.reserve(BINARY_TRACE_BLOCK_RECORDS);
+	return true;
+}
+
+bool binary_trace_streambuf::is_open() const {
+	return file.is_open();
+}
+
+void binary_trace_streambuf::close() {
+	if (!file.is_open()) {
+		return;
+	}
+	if (!line.empty()) {
+		encode_line(line);
+		line.clear();
+	}
+	write_records();
+
+	/**
+	 * The table of names follows the records, each name is its
+	 * length followed by its characters
+	 */
+	binary_trace_header header = {};
+	memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_TRACE_VERSION;
+	header.record_size = BINARY_TRACE_RECORD_SIZE;
+	header.record_count = record_count;
+	header.names_offset = BINARY_TRACE_HEADER_SIZE + record_count * BINARY_TRACE_RECORD_SIZE;
+	header.name_count = names.size();
+	for (const string &name : names) {
+		char length[4];
+		store_little_endian(name.size(), length, sizeof(length));
+		file.write(length, sizeof(length));
+		file.write(name.data(), name.size());
+	}
+	char bytes[BINARY_TRACE_HEADER_SIZE];
+	header.encode(bytes);
+	file.seekp(0);
+	file.write(bytes, sizeof(bytes));
+	file.close();
+
+	record_count = 0;
+	ids.clear();
+	names.clear();
+}
+
+binary_trace_streambuf::int_type binary_trace_streambuf::overflow(int_type c) {
+	if (traits_type::eq_int_type(c, traits_type::eof())) {
+		return traits_type::not_eof(c);
+	}
+	char ch = traits_type::to_char_type(c);
+	xsputn(&ch, 1);
+	return c;
+}
+
+std::streamsize binary_trace_streambuf::xsputn(const char *s, std::streamsize n) {
+	const char *end = s + n;
+	while (s < end) {
+		const char *eol = static_cast<const char*>(memchr(s, '\n', end - s));
+		if (!eol) {
+			line.append(s, end - s);
+			break;
+		}
+		line.append(s, eol - s);
+		encode_line(line);
+		line.clear();
+		s = eol + 1;
+	}
+	return n;
+}
+
+void binary_trace_streambuf::encode_line(const string &line) {
+	int64_t ms;
+	if (!line.empty() && isdigit(static_cast<unsigned char>(line[0]))) {
+		if (parse_time_line(line, ms)) {
+			write_record(TRACE_TIME, ms, 0);
+		} else {
+			write_record(TRACE_TIME_TEXT, 0, intern(line));
+		}
+	} else if (!encode_output_line(line)) {
+		write_record(TRACE_LINE_TEXT, 0, intern(line));
+	}
+}
+
+/**
+ * Encodes a line "[port: {value, ...}, ...] generated by model name".
+ * The line is rebuilt from its records, which are only written if
+ * they give back the same line.
+ */
+bool binary_trace_streambuf::encode_output_line(const string &line) {
+	size_t ports_end = line.rfind(GENERATED_BY);
+	if (line.empty() || line[0] != '[' || ports_end == string::npos) {
+		return false;
+	}
+	vector<binary_trace_record> encoded;
+	string rebuilt = "[";
+	size_t position = 1;
+	encoded.push_back({0, intern(line.substr(ports_end + sizeof(GENERATED_BY) - 1)),
+	                   TRACE_MODEL, 0, 0});
+	while (position < ports_end) {
+		size_t open = line.find(": {", position);
+		size_t close = line.find('}', open);
+		if (open == string::npos || close == string::npos || close > ports_end) {
+			return false;
+		}
+		if (encoded.size() > 1) {
+			rebuilt += ", ";
+		}
+		string port = line.substr(position, open - position);
+		size_t port_record = encoded.size();
+		encoded.push_back({0, intern(port), TRACE_PORT, 0, 0});
+		encoded[0].value++;
+		rebuilt += port + ": {";
+
+		size_t value_start = open + 3;
+		while (value_start < close) {
+			size_t value_end = line.find(", ", value_start);
+			if (value_end == string::npos || value_end > close) {
+				value_end = close;
+			}
+			string value = line.substr(value_start, value_end - value_start);
+			message_t msg;
+			if (encoded[port_record].value > 0) {
+				rebuilt += ", ";
+			}
+			if (parse_input(value.data(), value.data() + value.size(), msg) &&
+			    message_text(msg) == value) {
+				encoded.push_back({msg.packet_num, msg.payload_length, TRACE_VALUE, msg.alt_bit, 0});
+			} else {
+				encoded.push_back({0, intern(value), TRACE_VALUE_TEXT, 0, 0});
+			}
+			encoded[port_record].value++;
+			rebuilt += value;
+			value_start = value_end + 2;
+		}
+		rebuilt += "}";
+		position = close + 1;
+		if (position < ports_end && line.compare(position, 2, ", ") == 0) {
+			position += 2;
+		}
+	}
+	rebuilt += line.substr(ports_end);
+	if (rebuilt != line) {
+		return false;
+	}
+	for (const binary_trace_record &record : encoded) {
+		write_record(static_cast<binary_trace_kind>(record.kind), record.value,
+		             record.id, record.alt_bit);
+	}
+	return true;
+}
+
+void binary_trace_streambuf::write_record(binary_trace_kind kind, int64_t value,
+                                          uint32_t id, int8_t alt_bit) {
+	records.push_back({value, id, kind, alt_bit, 0});
+	record_count++;
+	if (records.size() == BINARY_TRACE_BLOCK_RECORDS) {
+		write_records();
+	}
+}
+
+void binary_trace_streambuf::write_records() {
+	vector<char> bytes(records.size() * BINARY_TRACE_RECORD_SIZE);
+	for (size_t r = 0; r < records.size(); r++) {
+		records[r].encode(&bytes[r * BINARY_TRACE_RECORD_SIZE]);
+	}
+	file.write(bytes.data(), bytes.size());
+	records.clear();
+}
+
+uint32_t binary_trace_streambuf::intern(const string &name) {
+	auto found = ids.find(name);
+	if (found != ids.end()) {
+		return found->second;
+	}
+	uint32_t id = names.size();
+	ids.emplace(name, id);
+	names.push_back(name);
+	return id;
+}
+
+bool decode_binary_trace(const char *trace_file_name, std::ostream *raw, std::ostream *table) {
+	ifstream file(trace_file_name, ios::binary);
+	string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	binary_trace_header header;
+	if (data.size() < BINARY_TRACE_HEADER_SIZE) {
+		return false;
+	}
+	header.decode(data.data());
+	if (memcmp(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != BINARY_TRACE_VERSION ||
+	    header.record_size != BINARY_TRACE_RECORD_SIZE ||
+	    header.names_offset != BINARY_TRACE_HEADER_SIZE + header.record_count * BINARY_TRACE_RECORD_SIZE ||
+	    header.names_offset > data.size()) {
+		return false;
+	}
+
+	/**
+	 * Reads the table of names
+	 */
+	vector<string> names;
+	size_t position = header.names_offset;
+	for (uint64_t i = 0; i < header.name_count; i++) {
+		if (data.size() - position < 4) {
+			return false;
+		}
+		uint32_t length = static_cast<uint32_t>(load_little_endian(data.data() + position, 4));
+		position += 4;
+		if (data.size() - position < length) {
+			return false;
+		}
+		names.push_back(data.substr(position, length));
+		position += length;
+	}
+
+	output_transformer transformer(table ? *table : cerr);
+	if (table) {
+		transformer.write_header();
+	}
+
+	/**
+	 * Rebuilds each line of the log from its records, the names
+	 * of the records checked as they are read
+	 */
+	const char *records = data.data() + BINARY_TRACE_HEADER_SIZE;
+	uint64_t i = 0;
+	auto next = [&](binary_trace_record &record) {
+		if (i == header.record_count) {
+			return false;
+		}
+		record.decode(records + i++ * BINARY_TRACE_RECORD_SIZE);
+		return record.kind == TRACE_TIME || record.kind == TRACE_VALUE ||
+		       record.id < names.size();
+	};
+	binary_trace_record record;
+	string line;
+	while (i < header.record_count) {
+		if (!next(record)) {
+			return false;
+		}
+		switch (record.kind) {
+		case TRACE_TIME:
+			line = time_text(record.value);
+			break;
+		case TRACE_TIME_TEXT:
+		case TRACE_LINE_TEXT:
+			line = names[record.id];
+			break;
+		case TRACE_MODEL: {
+			line = "[";
+			binary_trace_record model = record;
+			for (int64_t p = 0; p < model.value; p++) {
+				if (!next(record) || record.kind != TRACE_PORT) {
+					return false;
+				}
+				line += (p ? ", " : "") + names[record.id] + ": {";
+				binary_trace_record port = record;
+				for (int64_t v = 0; v < port.value; v++) {
+					if (!next(record)) {
+						return false;
+					}
+					if (v) {
+						line += ", ";
+					}
+					if (record.kind == TRACE_VALUE) {
+						message_t msg(record.value, record.alt_bit, record.id);
+						line += message_text(msg);
+					} else if (record.kind == TRACE_VALUE_TEXT) {
+						line += names[record.id];
+					} else {
+						return false;
+					}
+				}
+				line += "}";
+			}
+			line += GENERATED_BY + names[model.id];
+			break;
+		}
+		default:
+			return false;
+		}
+		if (raw) {
+			*raw << line << '\n';
+		}
+		if (table) {
+			transformer.transform_line(line);
+		}
+	}
+	return true;
+}
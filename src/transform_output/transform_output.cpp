@@ -16,12 +16,13 @@
  *      4- Subnet
  */
 
+#include <ctype.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <thread>
 
 #include "../../include/transform_output/transform_output.hpp"
 
@@ -41,225 +42,341 @@ std::string& rtrim(std::string& str, const std::string& chars = "\t\n\v\f\r ")
 }
 
 void transform_output(const char *ip_file_name, const char *op_file_name) {
-	
-	/**
-	 * Creating a file pointer which will hold input file name
-	 */
-	FILE *fp;
 
 	/**
-	 * temp array is used to store the one line read from input file.
-	 */
-	char line[512];
-	const char *pattern="00:";
-	
-	/**
-	 * string variables to hold imtermediate sub-strings extracted from input file
+	 * ifstream holds the input file, each line is read whole
+	 * whatever its length.
 	 */
-	std::string in, time, port, port_value, component, packet_num,altern_bit,component_gen_c;
+	ifstream inputfile(ip_file_name);
+	std::string line;
 
 	/**
 	 * ofstream creates a new output file if not present or clean the 
 	 * existing one before writing data to it.
 	 */
 	ofstream outputfile(op_file_name);
+	output_transformer transformer(outputfile);
+	transformer.write_header();
+
+	if(!inputfile.is_open()) {
+		printf("can't open %s \n",ip_file_name);
+	} else{
+		/**
+		 * getline loop iterate through the input file line by line until EOF
+		 * and give each line to the transformer.
+		 */
+		while(getline(inputfile, line)) {
+			transformer.transform_line(line);
+		}
+	}
+}
+
+output_transformer::output_transformer(std::ostream &table) : table(table) {}
 
+void output_transformer::write_header() {
 	/**
 	 * setting the column names for our output file.
 	 * setw() function is used to give indentation in the output file.
 	 */
-	outputfile << setw(7) << "Time" << setw(20) << "Value" << setw(22) 
+	table << setw(7) << "Time" << setw(20) << "Value" << setw(22) 
 	<< "Packet Number" << setw(22) << "Alternating Bit" << setw(18) 
 	<< "Port" << setw(18) << "Component" << endl;
-	outputfile <<"-------------------------------------------------------"
-				 "----------------------------------------------------"<<endl;
-	
-	//gcc users
-	if((fp = fopen(ip_file_name, "r")) == NULL) {
-		printf("can't open %s \n",ip_file_name);
-	} else{
+	table <<"-------------------------------------------------------"
+			"----------------------------------------------------"<<endl;
+}
+
+void output_transformer::transform_line(const std::string &line) {
+
+	if(line.empty()) {
+		return;
+	}
+
+	/**
+	 * A line that starts with a digit holds a time value. We retain it
+	 * and read lines until we encounter another time value. This is done
+	 * beacause each 'time' value will have port, port value and component
+	 * associated with it.
+	 */
+	if(isdigit(static_cast<unsigned char>(line[0]))) {
+		time = line;
+		time = rtrim(time);
+		return;
+	}
+
+	/**
+	 * if the line read start with a [], it means we doesn't have any activity 
+	 * performed in that time interval so we ignore this line from input file.
+	 */
+	if(line[0] != '[' || line.size() < 2 || line[1] == ']') {
+		return;
+	}
+
+	/**
+	 * The line is made of the ports and their values followed by the component
+	 * e.g : [iestream_input_defs<message_t>::out: {5}] generated by model generator_con
+	 * The component is the last word of the line.
+	 */
+	size_t ports_end = line.rfind(']');
+	if(ports_end == std::string::npos) {
+		return;
+	}
+	component = line.substr(line.find_last_of(' ') + 1);
+	component = rtrim(component);
+
+	/**
+	 * static models are named after their class template e.g : sender1<NDTime>
+	 * so the template arguments are removed to get the component.
+	 */
+	component = component.substr(0, component.find('<'));
+
+	/**
+	 * Each port is followed by its values between "{}" brackets. For each port
+	 * found we check it with port constant to check which port it is and then
+	 * extract every value of its message bag.
+	 */
+	size_t position = 1;
+	while(position < ports_end) {
+		size_t open = line.find('{', position);
+		size_t close = line.find('}', open);
+		if(open == std::string::npos || close == std::string::npos || close > ports_end) {
+			break;
+		}
+		std::string port_name = line.substr(position, open - position);
+
+		if(port_name.find("out") != std::string::npos){
+			port= "out";
+		}else if(port_name.find("dataOut") != std::string::npos){
+			port="dataOut";
+		}else if(port_name.find("packetSentOut") != std::string::npos){
+			port="packetSentOut";
+		} else if(port_name.find("ackReceivedOut") != std::string::npos){
+			port="ackReceivedOut";
+		}
+
 		/**
-		 * fgets loop iterate through the input file line by line until EOF and 
-		 * store the line read in temp[] char array.
+		 * if ports value is empty then we ignore such ports and continue.
+		 * Otherwise every value of the bag, separated by commas, is a row.
 		 */
-		while(fgets(line, 512, fp) != NULL) {
-
-			/**
-			 * The strstr() function searches the given string in the specified main string and 
-			 * returns the pointer to the first occurrence of the given string.
-			 * temp holds line read from file. str contains a predefined pattern to search through input file.
-			 * if loop specifically evaluates that we are searching for only time in input file. If the pattern 'str'
-			 * matches a time value in input file then if loop will be executed and we store the  time value in 'time'
-			 * string variable. We perform rtrim() on temp to remove any spaces present after string.
-			 * else loop will be executed if the line read from input file doesn't contain a time value.
-			 * for each time value read by 'if loop', we retain it and read lines until we encounter another time value.
-			 * This is done beacause each 'time' value will have port, port value and component  associated with it.
-			 */
-
-			if((strstr(line, pattern)) != NULL) {
-				time = line;
-				time = rtrim(time);
-			}else{
-
-				/**
-				 * if the line read start with a [], it means we doesn't have any activity performed in that time interval 
-				 * so we ignore this line from input file.
-				 * otherwise if code block will be executed and it will extract all the ports, port values and component  
-				 * associated with time value read previously.
-				 */
-				if(line[0]=='[' & line[1]!=']'){
-
-					/**
-					 * We use strtok() to extract all tokens in the line by using delimiter ']'
-					 * The idea behind this is to separate out component and port from each other.
-					 * token_1 holds the first part of line and token_2 holds second part of line read from imput file.
-					 * e.g : token_1 = [iestream_input_defs<message_t>::out: {5}
-					 *       token_2 = generated by model generator_con
-					 */
-					char* token = strtok(line, "]"); 
-	  				char* token_1 = token,* token_2 =strtok(NULL, "]");
-	  				
-	  				/**
-	  				 * divide token_2 by delimiter space (" ") to extract component part from it.
-	  				 * token_6 holds component part at the end of while loop.
-	  				 */
-	  				char* token_5 = strtok(token_2, " "), * token_6;
-	  				
-	  				/**
-				     * Keep printing tokens while one of the 
-				     * delimiters present in token_2. 
-				     */
-				    while (token_5 != NULL) { 
-				        component = token_5;
-				        token_5 = strtok(NULL, " ");
-				    } 
-				    
-				    /**
-				     * divide token_1 by delimiter comma (",") to extract all port and its corresponding values
-				     * while loop runs until all ports and its values are obtained
-				     * for each token retrieved in while loop, we check it with port constant to check if a port is
-				     * present in the token. If yes then we assign the port to string variable "port"
-				     */
-				    char* token_3 = strtok(token_1, ",");
-				    char* token_4;
-
-				    /**
-				     * Keep printing tokens while one of the 
-				     * delimiters present in token_3.
-				     */ 
-				    while (token_3 != NULL) { 
-
-				    	if(strstr(token_3,"out")){
-
-							port= "out";
-							
-						}else if(strstr(token_3,"dataOut")){
-
-							port="dataOut";
-
-						}else if(strstr(token_3,"packetSentOut")){
-
-						 	port="packetSentOut";
-
-						} else if(strstr(token_3,"ackReceivedOut")){
-
-						 	port="ackReceivedOut";
-						}
-						else if (component== "generator_con") {
-							component_gen_c = "generator_con";
-						}
-
-						/**
-						 * for each token_3, we extract the port value by using strstr() with "{" delimiter.
-						 * port value is present in a "{}" brackets.
-						 */
-						token_4 = strstr(token_3,"{");
-						
-						/**
-					 	 * if ports value is empty then we ignore such ports and 
-						 * continue. This is verifed if the length of token_4 is greater than 2.
-						 * if a value is obtained other than empty then we assign it to port_value variable.
-						 */
-			            if (strlen(token_4)>2){
-							
-							in = token_4;
-							port_value = in.substr( 1 , ( in.find_first_of('}', 0) - 1) );
-			        		/** 
-							* Check Alternating Bit status,only if it is equal to 1
-							*/
-							if (port_value.length() ==1 ){
-								packet_num = port_value.substr(0, port_value.length() - 0);
-								if ((component_gen_c == "generator_con") || (port_value == "5") ){
-										if (port !="packetSentOut"){
-											altern_bit = "NA";
-											component_gen_c = " ";
-										}
-								}
-
-							}
-						   /** 
-							* Sort packets that are less than 10 and find out alternating bit
-							*/
-							if (port_value.length() >1) {
- 								packet_num = port_value.substr(0, port_value.length() - 0);
-
-								/** 
-								 * Check if the there is a relevant packet number or alternating bit
-								 */
-								if ((component_gen_c == "generator_con") || (port_value == "-1")){
-									packet_num = "NA";
-									altern_bit = "NA";
-									component_gen_c = " ";
-
-								}
-								 /** 
-								  * check the above condition is not true
-								  */
-								 if ((component_gen_c != "generator_con") && (port_value != "-1")) {
-									altern_bit = port_value.substr(1, port_value.length() - 1);
-									packet_num = port_value.substr(0, port_value.length() - 1);
-								}
-							} 
-							/** 
-							 * Sort packets that are greater than 10 and find out alternating bit
-							 * to get the Alternating Bit only if the number is greater 100
-							 */  
-							if (port_value.length() > 2) { 
-								altern_bit = port_value.substr(2, port_value.length() - 2);
-								packet_num = port_value.substr(0, port_value.length() - 1);
-							}
-
-		        			/**
-		        			 *Getting our data and writing it to output file.
-		        			 * if time is not zero then we write the line to output file.
-		        			 */ 
-		        			if (outputfile.is_open()){
-		        				outputfile<<time<<setw(15)<<port_value<<setw(20)
-		        				<<packet_num<<setw(20)<<altern_bit<<setw(20) 
-		        				<<port<<setw(20)<<component;
-					
-							}else {
-								cout << "Unable to open file";
-							}
-						}
-						
-				        token_3 = strtok(NULL, ","); 
-				    } 
-				    
-				}
-				
+		size_t value_start = open + 1;
+		while(value_start < close) {
+			size_t value_end = line.find(',', value_start);
+			if(value_end == std::string::npos || value_end > close) {
+				value_end = close;
+			}
+			std::string value = line.substr(value_start, value_end - value_start);
+			value.erase(0, value.find_first_not_of(' '));
+			if(!value.empty()) {
+				transform_value(rtrim(value));
 			}
+			value_start = value_end + 1;
 		}
-		
-		/*Close the file if still open*/
-		if(fp) {
-			fclose(fp);
+
+		/**
+		 * skip the comma and the space before the next port
+		 */
+		position = line.find_first_not_of(", ", close + 1);
+	}
+}
+
+void output_transformer::transform_value(const std::string &value) {
+
+	port_value = value;
+
+	/** 
+	 * The message is written as packet_num[:alt_bit[:payload_length]]
+	 * so the packet number is the first field and the alternating bit,
+	 * if the message has one, the second field.
+	 */
+	size_t first = port_value.find(':');
+	packet_num = port_value.substr(0, first);
+	altern_bit = "NA";
+	if (first != std::string::npos) {
+		size_t second = port_value.find(':', first + 1);
+		altern_bit = port_value.substr(first + 1, second == std::string::npos ? 
+		                               std::string::npos : second - first - 1);
+		if (altern_bit == "-1") {
+			altern_bit = "NA";
+		}
+	}
+
+	/**
+	 *Getting our data and writing it to output file.
+	 * The component column keeps the width it had when the end of line
+	 * was read as part of the component.
+	 */ 
+	table<<time<<setw(15)<<port_value<<setw(20)
+	<<packet_num<<setw(20)<<altern_bit<<setw(20) 
+	<<port<<setw(19)<<component<<'\n';
+}
+
+transform_streambuf::transform_streambuf(output_transformer &transformer, 
+                                         std::streambuf *raw) :
+	transformer(transformer), raw(raw) {}
+
+void transform_streambuf::copy_to(std::streambuf *raw) {
+	this->raw = raw;
+}
+
+transform_streambuf::int_type transform_streambuf::overflow(int_type c) {
+	if (traits_type::eq_int_type(c, traits_type::eof())) {
+		return traits_type::not_eof(c);
+	}
+	char ch = traits_type::to_char_type(c);
+	xsputn(&ch, 1);
+	return c;
+}
+
+std::streamsize transform_streambuf::xsputn(const char *s, std::streamsize n) {
+	if (raw) {
+		raw->sputn(s, n);
+	}
+
+	/**
+	 * Every end of line completes the line kept so far
+	 */
+	const char *end = s + n;
+	while (s < end) {
+		const char *eol = static_cast<const char*>(memchr(s, '\n', end - s));
+		if (!eol) {
+			line.append(s, end - s);
+			break;
 		}
+		line.append(s, eol - s);
+		transformer.transform_line(line);
+		line.clear();
+		s = eol + 1;
+	}
+	return n;
+}
+
+int transform_streambuf::sync() {
+	return (raw && raw->pubsync() == -1) ? -1 : 0;
+}
 
-		if(outputfile) {
-			outputfile.close();
+async_streambuf::async_streambuf(size_t block_size) : front(block_size), back(block_size), 
+	back_size(0), back_full(false), stopping(false), target(nullptr) {
+	setp(front.data(), front.data() + front.size());
+}
+
+async_streambuf::~async_streambuf() {
+	stop();
+}
+
+void async_streambuf::start(std::streambuf *target) {
+	stop();
+	this->target = target;
+	stopping = false;
+	writer = std::thread(&async_streambuf::write_blocks, this);
+}
+
+void async_streambuf::stop() {
+	if (!writer.joinable()) {
+		return;
+	}
+	hand_over();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	changed.notify_all();
+	writer.join();
+	target->pubsync();
+	target = nullptr;
+}
+
+/**
+ * Waits until the writer thread has taken the previous block and
+ * gives it the block filled so far
+ */
+void async_streambuf::hand_over() {
+	size_t size = pptr() - pbase();
+	if (size == 0) {
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this]{ return !back_full; });
+		front.swap(back);
+		back_size = size;
+		back_full = true;
+	}
+	changed.notify_all();
+	setp(front.data(), front.data() + front.size());
+}
+
+/**
+ * Loop of the writer thread, it writes the blocks handed over
+ * until it is stopped and no block is left
+ */
+void async_streambuf::write_blocks() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		changed.wait(lock, [this]{ return back_full || stopping; });
+		if (!back_full) {
+			break;
 		}
+		lock.unlock();
+		target->sputn(back.data(), back_size);
+		lock.lock();
+		back_full = false;
+		changed.notify_all();
+	}
+}
+
+async_streambuf::int_type async_streambuf::overflow(int_type c) {
+	if (!writer.joinable()) {
+		return traits_type::eof();
+	}
+	hand_over();
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
 	}
+	return traits_type::not_eof(c);
+}
+
+int async_streambuf::sync() {
+	return 0;
+}
+
+transform_sink::transform_sink() : transformer(table_file), buffer(transformer), out(&buffer) {}
 
+void transform_sink::open(const char *table_file_name, const char *raw_file_name, 
+                          bool asynchronous) {
+	table_file.open(table_file_name);
+	transformer.write_header();
+	if (raw_file_name) {
+		raw_file.open(raw_file_name);
+		buffer.copy_to(raw_file.rdbuf());
+	} else {
+		buffer.copy_to(nullptr);
+	}
+	if (asynchronous) {
+		async.start(&buffer);
+		out.rdbuf(&async);
+	} else {
+		out.rdbuf(&buffer);
+	}
+}
 
-}
\ No newline at end of file
+void transform_sink::open_binary(const char *trace_file_name) {
+	binary.open(trace_file_name);
+	async.start(&binary);
+	out.rdbuf(&async);
+}
+
+void transform_sink::close() {
+	out.flush();
+	async.stop();
+	out.rdbuf(&buffer);
+	binary.close();
+	buffer.copy_to(nullptr);
+	if (raw_file.is_open()) {
+		raw_file.close();
+	}
+	table_file.close();
+}
+
+std::ostream& transform_sink::stream() {
+	return out;
+}
@@ -0,0 +1,177 @@
+/**  \brief This main file tests the loss models and delay distributions of the subnets
+ *
+ * This file draws the fates and the delays of many packets from the
+ * channel models of the subnets with a fixed seed: the Gilbert-Elliott
+ * loss model, whose losses come in bursts, beside independent losses
+ * of the same rate, and the constant and empirical delays, the
+ * samples of the empirical delays read from a file. It stores the
+ * first draws and the measures of all of them in the output file, and
+ * the test fails if the measures are not the ones of the models: the
+ * loss rate and the mean length of the bursts, and the delays clipped
+ * and rounded as given and drawn evenly from the samples.
+ *
+ */
+
+#include <iostream>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../include/random/channel_model.hpp"
+#include "../../include/random/random_generator.hpp"
+
+//define new input and output filename and path
+#define CHANNEL_MODEL_DELAYS_FILE_PATH "test/data/channel_model_delays_test.txt"
+#define CHANNEL_MODEL_OUTPUT_FILE_PATH "test/data/channel_model_test_output.txt"
+
+//define the number of packets drawn and the number of first draws stored
+#define CHANNEL_MODEL_PACKETS 200000
+#define CHANNEL_MODEL_SHOWN 40
+
+using namespace std;
+
+/**
+ * Number of measures not within their tolerance
+ */
+static int failures = 0;
+
+/**
+ * Stores a measure and checks it is close to the value of the model
+ * @param os the output stream
+ * @param name name of the measure
+ * @param measured value measured
+ * @param expected value of the model
+ * @param tolerance largest difference accepted
+ */
+void check(ostream &os, const char *name, double measured, double expected, double tolerance){
+    bool passed = fabs(measured - expected) <= tolerance;
+    os << name << ": " << fixed << setprecision(4) << measured
+       << " (expected " << expected << ")" << (passed ? "" : " FAILED") << endl;
+    if (!passed){
+        cout << name << " is " << measured << ", expected " << expected << endl;
+        failures++;
+    }
+}
+
+/**
+ * Draws the fates of packets from a loss model, stores the first ones,
+ * P for a packet passed and L for a packet lost, and checks the loss
+ * rate and the mean number of packets lost in a row
+ * @param os the output stream
+ * @param name name of the loss model
+ * @param loss the loss model
+ * @param loss_rate loss rate of the model
+ * @param burst_length mean length of its bursts of losses
+ */
+void test_losses(ostream &os, const char *name, loss_model loss,
+                 double loss_rate, double burst_length){
+    random_generator generator(DEFAULT_RANDOM_SEED, 0);
+    string first;
+    uint64_t lost = 0, bursts = 0;
+    bool in_burst = false;
+    for (int i = 0; i < CHANNEL_MODEL_PACKETS; i++){
+        bool passed = loss.pass(generator);
+        if (i < CHANNEL_MODEL_SHOWN){
+            first += passed ? 'P' : 'L';
+        }
+        lost += !passed;
+        bursts += !passed && !in_burst;
+        in_burst = !passed;
+    }
+    os << name << ": " << first << endl;
+    check(os, "  loss rate", double(lost) / CHANNEL_MODEL_PACKETS, loss_rate, 0.005);
+    check(os, "  mean burst length", double(lost) / bursts, burst_length, 0.1);
+}
+
+/**
+ * Draws the delays of packets from a channel, stores the first ones
+ * and checks every delay is one of the delays expected, drawn as
+ * often as expected
+ * @param os the output stream
+ * @param name name of the channel
+ * @param channel the channel
+ * @param frequencies delays expected in milliseconds and their frequencies
+ */
+void test_delays(ostream &os, const char *name, subnet_channel channel,
+                 const map<int64_t, double> &frequencies){
+    random_generator generator(DEFAULT_RANDOM_SEED, 1);
+    map<int64_t, uint64_t> counts;
+    os << name << ":";
+    for (int i = 0; i < CHANNEL_MODEL_PACKETS; i++){
+        int64_t delay = channel.draw_delay_ms(generator);
+        if (i < CHANNEL_MODEL_SHOWN / 2){
+            os << " " << delay;
+        }
+        counts[delay]++;
+    }
+    os << endl;
+    for (const pair<const int64_t, uint64_t> &count : counts){
+        if (!frequencies.count(count.first)){
+            os << "  unexpected delay " << count.first << " FAILED" << endl;
+            cout << name << " drew the unexpected delay " << count.first << endl;
+            failures++;
+        }
+    }
+    for (const pair<const int64_t, double> &frequency : frequencies){
+        string measure = "  frequency of " + to_string(frequency.first) + " ms";
+        check(os, measure.c_str(), double(counts[frequency.first]) / CHANNEL_MODEL_PACKETS,
+              frequency.second, 0.005);
+    }
+}
+
+int main() {
+
+    ofstream output(CHANNEL_MODEL_OUTPUT_FILE_PATH);
+
+    /**
+     * Gilbert-Elliott channel losing every packet of its bursts, which
+     * start before 5% of the packets and last 4 packets on average, and
+     * independent losses of the same rate, 1/6 of the packets, whose
+     * mean length is 1.2 packets
+     */
+    gilbert_elliott_loss bursty{1.0, 0.0, 0.05, 0.25};
+    test_losses(output, "Gilbert-Elliott losses", loss_model(bursty), 0.05 / 0.3, 4.0);
+    test_losses(output, "Bernoulli losses", loss_model(bernoulli_loss{5.0 / 6}), 1.0 / 6, 1.2);
+
+    /**
+     * Constant delays rounded to a second, to 100 ms, and clipped
+     * to a minimum delay
+     */
+    subnet_channel constant{loss_model(), delay_model(constant_delay{2.4})};
+    test_delays(output, "Constant delay of 2.4 s", constant, {{2000, 1.0}});
+    constant.resolution_ms = 100;
+    test_delays(output, "Constant delay of 2.4 s by 100 ms", constant, {{2400, 1.0}});
+    constant.delay_min = 3.0;
+    test_delays(output, "Constant delay of 2.4 s clipped to 3 s", constant, {{3000, 1.0}});
+
+    /**
+     * Empirical delays drawn from the samples of the delays file,
+     * rounded to 250 ms
+     */
+    vector<double> samples;
+    if (!read_delay_samples(CHANNEL_MODEL_DELAYS_FILE_PATH, samples)){
+        cout << "The delays file " << CHANNEL_MODEL_DELAYS_FILE_PATH << " is not valid" << endl;
+        return 1;
+    }
+    subnet_channel empirical{loss_model(),
+                             delay_model(empirical_delay{
+                                 make_shared<const vector<double>>(samples)})};
+    empirical.resolution_ms = 250;
+    map<int64_t, double> frequencies;
+    for (double sample : samples){
+        frequencies[int64_t(sample * 1000)] += 1.0 / samples.size();
+    }
+    test_delays(output, "Empirical delay by 250 ms", empirical, frequencies);
+
+    if (failures){
+        cout << failures << " measures are not the ones of the models" << endl;
+        return 1;
+    }
+    cout << "Every measure is the one of the models" << endl;
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**  \brief This main file tests the checkpoints of the ABP Simulator
+ *
+ * This file runs the top model three times on the same input: once
+ * without stopping until time 04:00:00:000, once until 00:05:00:000
+ * where its state is saved to a checkpoint, and once from the state
+ * restored from that checkpoint until 04:00:00:000. The log and the
+ * results of both runs are stored, and the test fails if the log
+ * saved followed by the log restored is not the log of the run
+ * that was not stopped, or if their results differ.
+ *
+ */
+
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_checkpoint.hpp"
+#include "../../include/top_model/abp_top_model.hpp"
+
+//define new input and output filename and path
+#define CHECKPOINT_INPUT_FILE_PATH "test/data/checkpoint_input_test.txt"
+#define CHECKPOINT_OUTPUT_FILE_PATH "test/data/checkpoint_test_output.txt"
+#define CHECKPOINT_RESTORED_OUTPUT_FILE_PATH "test/data/checkpoint_test_output_restored.txt"
+#define CHECKPOINT_FILE_PATH "bin/test/checkpoint_test.chk"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Log of the run being run
+ */
+static ostringstream *current_log = nullptr;
+
+/**
+ * This is a common sink provider structure
+ * which returns the log of the run being run
+ */
+struct oss_sink_provider{
+    static std::ostream& sink() {
+        return *current_log;
+    }
+};
+
+using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages,
+                     cadmium::dynamic::logger::formatter<TIME>,
+                     oss_sink_provider>;
+using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time,
+                    cadmium::dynamic::logger::formatter<TIME>,
+                    oss_sink_provider>;
+using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+
+/**
+ * Builds the top model of the input file, resumable
+ */
+abp_top_model<TIME> make_model(){
+    return make_abp_top_model<TIME>(CHECKPOINT_INPUT_FILE_PATH, DEFAULT_RANDOM_SEED,
+                                    abp_parameters<TIME>(), false, true);
+}
+
+/**
+ * Runs a model from a time until another one, writing its log. The
+ * time logged by the runner of a restored run when it is created is
+ * not written, as the log it continues already has it.
+ * @param model the model
+ * @param from time the runner is created at
+ * @param until time the model is ran until
+ * @param log the log
+ * @param restored true if the model was restored from a checkpoint
+ */
+void run(const abp_top_model<TIME> &model, const TIME &from, const TIME &until,
+         ostringstream &log, bool restored){
+    ostringstream creation_log;
+    current_log = restored ? &creation_log : &log;
+    cadmium::dynamic::engine::runner<TIME, logger_top> r(model.top, from);
+    current_log = &log;
+    r.run_until(until);
+    current_log = nullptr;
+}
+
+/**
+ * Stores the log and the results of a run in a file
+ * @param file path of the file
+ * @param log the log
+ * @param results the results
+ */
+void store_run(const char *file, const string &log, const string &results){
+    ofstream os(file);
+    os << log << results;
+}
+
+int main() {
+
+    //to measure simulation execution time
+    auto start = hclock::now();
+    const TIME end("04:00:00:000");
+    const TIME saved_at("00:05:00:000");
+
+    /**
+     * The run that is not stopped
+     */
+    abp_top_model<TIME> uninterrupted = make_model();
+    ostringstream uninterrupted_log;
+    run(uninterrupted, TIME(), end, uninterrupted_log, false);
+    ostringstream uninterrupted_results;
+    print_abp_results(uninterrupted_results, collect_abp_results(uninterrupted, end));
+
+    /**
+     * The run that is saved, then restored in a new model
+     */
+    ostringstream restored_log;
+    {
+        abp_top_model<TIME> saved = make_model();
+        run(saved, TIME(), saved_at, restored_log, false);
+        if (!save_abp_checkpoint(CHECKPOINT_FILE_PATH, saved, saved_at)){
+            cout << "The checkpoint " << CHECKPOINT_FILE_PATH << " cannot be written" << endl;
+            return 1;
+        }
+    }
+    abp_top_model<TIME> restored = make_model();
+    TIME time;
+    if (!restore_abp_checkpoint(CHECKPOINT_FILE_PATH, restored, time) || !(time == saved_at)){
+        cout << "The checkpoint " << CHECKPOINT_FILE_PATH << " cannot be restored" << endl;
+        return 1;
+    }
+    run(restored, time, end, restored_log, true);
+    ostringstream restored_results;
+    print_abp_results(restored_results, collect_abp_results(restored, end));
+
+    store_run(CHECKPOINT_OUTPUT_FILE_PATH, uninterrupted_log.str(), uninterrupted_results.str());
+    store_run(CHECKPOINT_RESTORED_OUTPUT_FILE_PATH, restored_log.str(), restored_results.str());
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+    std::ratio<1>>>(hclock::now() - start).count();
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+
+    if (uninterrupted_log.str() != restored_log.str()){
+        cout << "The log of the restored run differs from the log of the run not stopped" << endl;
+        return 1;
+    }
+    if (uninterrupted_results.str() != restored_results.str()){
+        cout << "The results of the restored run differ from the results of the run not stopped:\n"
+             << restored_results.str() << endl;
+        return 1;
+    }
+    cout << "The restored run is the run not stopped" << endl;
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**  \brief This main file tests the conservative run of the flows
+ *
+ * This file builds six flows fed by the same control input, over
+ * subnets with a minimum delay: two flows with the default subnets,
+ * two whose subnets queue the packets on a slow link, and two that
+ * send a packet again sooner than the minimum delay of their subnets,
+ * so the packets sent again replace the ones the subnets are still
+ * transmitting before the network announced their delivery.
+ * The flows are run twice until time 04:00:00:000: by the single
+ * runner of the multi-flow top model, and as the two logical
+ * processes of the conservative run. The results of every flow and
+ * of all of them are stored, and the test fails if the results of
+ * the conservative run are not the ones of the single runner.
+ *
+ */
+
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_conservative.hpp"
+#include "../../include/top_model/abp_flows.hpp"
+
+//define new input and output filename and path
+#define CONSERVATIVE_INPUT_FILE_PATH "test/data/conservative_input_test.txt"
+#define CONSERVATIVE_SEQUENTIAL_OUTPUT_FILE_PATH "test/data/conservative_test_output_sequential.txt"
+#define CONSERVATIVE_OUTPUT_FILE_PATH "test/data/conservative_test_output.txt"
+
+#define CONSERVATIVE_TEST_FLOWS_PER_GROUP 2
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Writes the results of every flow of a finished run followed by
+ * the results of all of them
+ * @param flows flows of the run
+ * @param until time the run ended
+ * @return the results written
+ */
+string write_results(const abp_flows_model<TIME> &flows, const TIME &until){
+    ostringstream os;
+    for (size_t flow = 0; flow < flows.flows.size(); flow++){
+        os << "Flow " << flow + 1 << endl;
+        print_abp_results(os, collect_abp_results(flows.flows[flow], until));
+    }
+    os << "Flows: " << flows.flows.size() << endl;
+    print_abp_results(os, collect_abp_flows_results(flows, until));
+    return os.str();
+}
+
+/**
+ * Stores results in a file
+ * @param file path of the file
+ * @param results the results
+ */
+void store_results(const char *file, const string &results){
+    ofstream os(file);
+    os << results;
+}
+
+int main() {
+
+    //to measure simulation execution time
+    auto start = hclock::now();
+
+    abp_sweep_point plain = to_sweep_point(abp_parameters<TIME>());
+    plain[DELAY_MIN] = 3;
+    plain[DELAY_MEAN] = 5;
+    abp_sweep_point queued = to_sweep_point(abp_parameters<TIME>());
+    queued[DELAY_MIN] = 3;
+    queued[DELAY_MEAN] = 4;
+    queued[PASS_PROBABILITY] = 0.9;
+    queued[QUEUE_CAPACITY] = 2;
+    queued[BANDWIDTH] = 50;
+    queued[SENDER_TIMEOUT] = 5;
+    abp_sweep_point replacing = to_sweep_point(abp_parameters<TIME>());
+    replacing[DELAY_MIN] = 3;
+    replacing[DELAY_MEAN] = 8;
+    replacing[DELAY_STDDEV] = 4;
+    replacing[PASS_PROBABILITY] = 0.8;
+    replacing[SENDER_PREPARATION] = 1;
+    replacing[SENDER_TIMEOUT] = 12;
+    replacing[RECEIVER_PREPARATION] = 1;
+    vector<abp_flow_group> groups = {
+        {CONSERVATIVE_TEST_FLOWS_PER_GROUP, plain},
+        {CONSERVATIVE_TEST_FLOWS_PER_GROUP, queued},
+        {CONSERVATIVE_TEST_FLOWS_PER_GROUP, replacing}
+    };
+    TIME until("04:00:00:000");
+
+    /**
+     * Runs all the flows by a single runner
+     */
+    abp_flows_model<TIME> model = make_abp_flows_model<TIME>(CONSERVATIVE_INPUT_FILE_PATH, groups);
+    {
+        cadmium::dynamic::engine::runner<TIME, cadmium::logger::not_logger> r(model.top, {0});
+        r.run_until(until);
+    }
+    string sequential = write_results(model, until);
+    store_results(CONSERVATIVE_SEQUENTIAL_OUTPUT_FILE_PATH, sequential);
+
+    /**
+     * Runs the same flows as the endpoints and the network logical
+     * processes
+     */
+    abp_conservative_model<TIME> conservative = make_abp_conservative_model<TIME>(
+                                                    CONSERVATIVE_INPUT_FILE_PATH, groups);
+    uint64_t windows = run_abp_conservative(conservative, until);
+    abp_flows_model<TIME> conservative_flows;
+    conservative_flows.flows = conservative.flows;
+    string results = write_results(conservative_flows, until);
+    store_results(CONSERVATIVE_OUTPUT_FILE_PATH, results);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+    std::ratio<1>>>(hclock::now() - start).count();
+    cout << "Simulation took:" << elapsed << "sec, the conservative run in "
+         << windows << " windows" << endl;
+
+    /**
+     * Compares the two results line by line
+     */
+    istringstream expected(sequential), actual(results);
+    string expected_line, actual_line;
+    for (size_t line = 1; ; line++){
+        bool more_expected = static_cast<bool>(getline(expected, expected_line));
+        bool more_actual = static_cast<bool>(getline(actual, actual_line));
+        if (!more_expected && !more_actual){
+            break;
+        }
+        if (more_expected != more_actual || expected_line != actual_line){
+            cout << "The conservative results differ from the sequential results at line " << line
+                 << ":\n  sequential:   " << (more_expected ? expected_line : "end of results")
+                 << "\n  conservative: " << (more_actual ? actual_line : "end of results") << endl;
+            return 1;
+        }
+    }
+    cout << "The conservative results are the sequential results" << endl;
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/**  \brief This main file tests the partitioned runner of the flows
+ *
+ * This file builds six flows fed by the same control input and
+ * runs them twice until time 04:00:00:000: by a single runner, and
+ * as three partitions by the partitioned runner on three threads,
+ * synchronized every minute. Both logs are stored, and the test
+ * fails if the merged log of the partitions is not the log of the
+ * single runner.
+ *
+ */
+
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../include/top_model/abp_flows.hpp"
+#include "../../include/parallel/partitioned_runner.hpp"
+
+//define new input and output filename and path
+#define PARTITIONED_INPUT_FILE_PATH "test/data/partitioned_input_test.txt"
+#define PARTITIONED_SEQUENTIAL_OUTPUT_FILE_PATH "test/data/partitioned_test_output_sequential.txt"
+#define PARTITIONED_OUTPUT_FILE_PATH "test/data/partitioned_test_output.txt"
+
+#define PARTITIONED_TEST_FLOWS 6
+#define PARTITIONED_TEST_PARTITIONS 3
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Log of the single runner, the partitions log to their own stream
+ */
+static ostringstream sequential_log;
+
+/**
+ * This is a common sink provider structure which returns the stream
+ * of the partition run by the thread, or the log of the single runner
+ */
+struct oss_sink_provider{
+    static std::ostream& sink() {
+        std::ostream *partition = partition_stream();
+        return partition ? *partition : sequential_log;
+    }
+};
+
+using log_messages = cadmium::logger::logger<cadmium::logger::logger_messages,
+                     cadmium::dynamic::logger::formatter<TIME>,
+                     oss_sink_provider>;
+using global_time = cadmium::logger::logger<cadmium::logger::logger_global_time,
+                    cadmium::dynamic::logger::formatter<TIME>,
+                    oss_sink_provider>;
+using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+
+/**
+ * Stores a log in a file
+ * @param file path of the file
+ * @param log the log
+ */
+void store_log(const char *file, const string &log){
+    ofstream os(file);
+    os << log;
+}
+
+int main() {
+
+    //to measure simulation execution time
+    auto start = hclock::now();
+
+    vector<abp_flow_group> groups = {
+        {PARTITIONED_TEST_FLOWS, to_sweep_point(abp_parameters<TIME>())}
+    };
+
+    /**
+     * Runs all the flows by a single runner
+     */
+    abp_flows_model<TIME> model = make_abp_flows_model<TIME>(PARTITIONED_INPUT_FILE_PATH, groups);
+    {
+        cadmium::dynamic::engine::runner<TIME, logger_top> r(model.top, {0});
+        r.run_until(NDTime("04:00:00:000"));
+    }
+    string sequential = sequential_log.str();
+    store_log(PARTITIONED_SEQUENTIAL_OUTPUT_FILE_PATH, sequential);
+
+    /**
+     * Runs the same flows as partitions of consecutive flows, each
+     * with its own copy of the control generator
+     */
+    ostringstream partitioned_log;
+    {
+        vector<typename partitioned_runner<TIME, logger_top>::top_model> tops;
+        vector<abp_flows_model<TIME>> partitions;
+        for (uint64_t p = 0; p < PARTITIONED_TEST_PARTITIONS; p++){
+            uint64_t first = 1 + p * PARTITIONED_TEST_FLOWS / PARTITIONED_TEST_PARTITIONS;
+            uint64_t last = 1 + (p + 1) * PARTITIONED_TEST_FLOWS / PARTITIONED_TEST_PARTITIONS;
+            partitions.push_back(make_abp_flows_model<TIME>(PARTITIONED_INPUT_FILE_PATH, groups,
+                                                            DEFAULT_RANDOM_SEED, false,
+                                                            first, last - first));
+            tops.push_back(partitions.back().top);
+        }
+        partitioned_runner<TIME, logger_top> r(tops, {0}, PARTITIONED_TEST_PARTITIONS,
+                                               "generator_con", &partitioned_log);
+        r.run_until(NDTime("04:00:00:000"), NDTime("00:01:00:000"));
+    }
+    string partitioned = partitioned_log.str();
+    store_log(PARTITIONED_OUTPUT_FILE_PATH, partitioned);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+    std::ratio<1>>>(hclock::now() - start).count();
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+
+    /**
+     * Compares the two logs line by line
+     */
+    istringstream expected(sequential), actual(partitioned);
+    string expected_line, actual_line;
+    for (size_t line = 1; ; line++){
+        bool more_expected = static_cast<bool>(getline(expected, expected_line));
+        bool more_actual = static_cast<bool>(getline(actual, actual_line));
+        if (!more_expected && !more_actual){
+            break;
+        }
+        if (more_expected != more_actual || expected_line != actual_line){
+            cout << "The partitioned log differs from the sequential log at line " << line
+                 << ":\n  sequential:  " << (more_expected ? expected_line : "end of log")
+                 << "\n  partitioned: " << (more_actual ? actual_line : "end of log") << endl;
+            return 1;
+        }
+    }
+    cout << "The partitioned log is the sequential log" << endl;
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**  \brief This main file tests the estimator of the retransmission timeout
+ *
+ * This file reads a sequence of operations on the estimator from the
+ * input file: the creation of an estimator with its initial timeout,
+ * the samples of round trip times and the backoffs after a timeout
+ * expired. After each one it stores the smoothed round trip time, the
+ * mean deviation and the timeout of the estimator in the output file,
+ * and the test fails if they are not the ones the input file expects.
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../../include/metrics/rtt_estimator.hpp"
+
+//define new input and output filename and path
+#define RTT_ESTIMATOR_INPUT_FILE_PATH "test/data/rtt_estimator_input_test.txt"
+#define RTT_ESTIMATOR_OUTPUT_FILE_PATH "test/data/rtt_estimator_test_output.txt"
+
+using namespace std;
+
+int main() {
+
+    ifstream input(RTT_ESTIMATOR_INPUT_FILE_PATH);
+    ofstream output(RTT_ESTIMATOR_OUTPUT_FILE_PATH);
+    if (!input){
+        cout << "The input file " << RTT_ESTIMATOR_INPUT_FILE_PATH << " cannot be read" << endl;
+        return 1;
+    }
+    output << "operation rtt_ms smoothed_ms deviation_ms timeout_ms" << endl;
+
+    /**
+     * Each line is an operation, its round trip time or initial
+     * timeout in milliseconds, - for a backoff, and the smoothed
+     * round trip time, the mean deviation and the timeout expected
+     */
+    rtt_estimator estimator;
+    string line;
+    int failures = 0;
+    for (int number = 1; getline(input, line); number++){
+        istringstream fields(line);
+        string operation, value;
+        int64_t smoothed, deviation, timeout;
+        if (!(fields >> operation) || operation[0] == '#'){
+            continue;
+        }
+        if (!(fields >> value >> smoothed >> deviation >> timeout)){
+            cout << "Line " << number << " of the input file is not valid" << endl;
+            return 1;
+        }
+        if (operation == "start"){
+            estimator = rtt_estimator(stoll(value));
+        } else if (operation == "sample"){
+            estimator.sample(stoll(value));
+        } else if (operation == "back_off"){
+            estimator.back_off();
+        } else{
+            cout << "Line " << number << " of the input file is not valid" << endl;
+            return 1;
+        }
+        output << operation << " " << value << " " << estimator.smoothed_ms() << " "
+               << estimator.deviation_ms() << " " << estimator.timeout_ms() << endl;
+        if (estimator.smoothed_ms() != smoothed || estimator.deviation_ms() != deviation ||
+            estimator.timeout_ms() != timeout){
+            cout << "Line " << number << ": expected " << smoothed << " " << deviation << " "
+                 << timeout << ", got " << estimator.smoothed_ms() << " "
+                 << estimator.deviation_ms() << " " << estimator.timeout_ms() << endl;
+            failures++;
+        }
+    }
+
+    if (failures){
+        cout << failures << " operations did not give the expected estimation" << endl;
+        return 1;
+    }
+    cout << "Every operation gave the expected estimation" << endl;
+
+    return 0;
+}
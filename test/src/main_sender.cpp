@@ -87,8 +87,10 @@ int main() {
      * To generate messages and operation logs which are being passed
      * during execution time of this application and storing them
      * in the sender_test_output file as indicated out_data.
+     * The log is transformed to the table file while it is written.
      */
-    static std::ofstream out_data(output_file);
+    static transform_sink out_data;
+    out_data.open(transform_output_file, output_file);
     
     /**
      * This is a common sink provider structure 
@@ -97,7 +99,7 @@ int main() {
      */
     struct oss_sink_provider{
             static std::ostream& sink() {          
-                return out_data;
+                return out_data.stream();
             }
     };
 
@@ -272,9 +274,9 @@ int main() {
     cout << "Simulation took:" << elapsed << "sec" << endl;
 
     /**
-     * transform the output file generated by simulator to readable text
+     * close the log and its table once the simulation is over
      */
-    transform_output(output_file,transform_output_file);
+    out_data.close();
 
 
     return 0;
@@ -6,6 +6,13 @@
  * It runs with respect to input provided by input file and 
  * runs simulation until time 04:00:00:000 is reached.
  *
+ * It then runs a subnet with a queue of 2 packets on a link of
+ * 100 bytes per second, passing every packet after a constant delay
+ * of 2 seconds, with the packets of a second input file sent faster
+ * than the link transmits them: its log shows the packets dropped at
+ * the tail of the full queue and the others delivered in the order
+ * they were received.
+ *
  */
 
 #include <iostream>
@@ -35,6 +42,9 @@
 #define SUBNET_INPUT_FILE_PATH "test/data/subnet_input_test.txt"
 #define SUBNET_OUTPUT_FILE_PATH "test/data/subnet_test_output.txt"
 #define SUBNET_TRANSFORM_OUTPUT_FILE_PATH "test/data/subnet_test_output_transform.txt"
+#define SUBNET_QUEUE_INPUT_FILE_PATH "test/data/subnet_queue_input_test.txt"
+#define SUBNET_QUEUE_OUTPUT_FILE_PATH "test/data/subnet_queue_test_output.txt"
+#define SUBNET_QUEUE_TRANSFORM_OUTPUT_FILE_PATH "test/data/subnet_queue_test_output_transform.txt"
 
 using namespace std;
 
@@ -85,8 +95,17 @@ int main() {
      * To generate messages and operation logs which are being passed
      * during execution time of this application and storing them
      * in the receiver_test_output file as indicated out_data.
+     * The log is transformed to the table file while it is written.
+     */
+    static transform_sink out_data;
+    out_data.open(transform_output_file, output_file);
+
+    /**
+     * The log of the subnet with a queue, written once the first
+     * simulation is over
      */
-    static std::ofstream out_data(output_file);
+    static transform_sink queue_data;
+    static transform_sink *current_data = &out_data;
   
 
     /**
@@ -96,7 +115,7 @@ int main() {
      */
     struct oss_sink_provider{
         static std::ostream& sink() {          
-            return out_data;
+            return current_data->stream();
         }
     };
 
@@ -227,9 +246,58 @@ int main() {
     cout << "Simulation took:" << elapsed << "sec" << endl;
 
     /**
-     * transform the output file generated by simulator to readable text
+     * close the log and its table once the simulation is over
+     */
+    out_data.close();
+
+    /**
+     * The subnet with a queue, fed by its own generator, the packets
+     * received while the queue is full are dropped
      */
-    transform_output(output_file,transform_output_file);
+    string queue_input_data = SUBNET_QUEUE_INPUT_FILE_PATH;
+    const char * i_queue_input_data = queue_input_data.c_str();
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator_queue = 
+                    cadmium::dynamic::translate::make_dynamic_atomic_model
+                    <ApplicationGen, 
+                     TIME, 
+                     const char* >("generator" ,
+                                   std::move(i_queue_input_data)
+                                   );
+    subnet_channel channel{bernoulli_loss{1.0}, constant_delay{2.0}};
+    subnet_queue queue;
+    queue.capacity = 2;
+    queue.bandwidth = 100;
+    queue.packet_size = 1000;
+    std::shared_ptr<cadmium::dynamic::modeling::model> subnet_queue1 = 
+    cadmium::dynamic::translate::make_dynamic_atomic_model
+    <Subnet, 
+     TIME, 
+     random_generator, 
+     subnet_channel, 
+     subnet_queue>("subnet1", 
+                   random_generator(), 
+                   std::move(channel), 
+                   std::move(queue)
+                   );
+    cadmium::dynamic::modeling::Models submodels_QUEUE = {
+        generator_queue,
+        subnet_queue1
+    };
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> QUEUE = 
+    std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>("TOP", 
+                                                                submodels_QUEUE, 
+                                                                iports_TOP, 
+                                                                oports_TOP, 
+                                                                eics_TOP, 
+                                                                eocs_TOP, 
+                                                                ics_TOP 
+                                                                );
+
+    queue_data.open(SUBNET_QUEUE_TRANSFORM_OUTPUT_FILE_PATH, SUBNET_QUEUE_OUTPUT_FILE_PATH);
+    current_data = &queue_data;
+    cadmium::dynamic::engine::runner<NDTime, logger_top> r_queue(QUEUE, {0});
+    r_queue.run_until(NDTime("04:00:00:000"));
+    queue_data.close();
 
     return 0;
 }
\ No newline at end of file